@@ -1,120 +1,205 @@
 #include "attacks.hpp"
 
-namespace chess {
+#include <cassert>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define ATTACK_FILL_SIMD 2
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define ATTACK_FILL_SIMD 1
+#else
+#define ATTACK_FILL_SIMD 0
+#endif
 
-Bitboard pawn_attacks[2][64];
-Bitboard knight_attacks[64];
-Bitboard king_attacks[64];
+namespace chess {
 
-static inline bool on_board(int f, int r) { return f >= 0 && f < 8 && r >= 0 && r < 8; }
+// fills one slider type's payload; false on a magic collision
+static bool fill_magics(const Magic* magics, bool bishop) {
+    for (int sq = 0; sq < 64; ++sq) {
+        const Magic& m = magics[sq];
+
+        const std::size_t size = std::size_t(1) << popcount(m.mask);
+        for (std::size_t i = 0; i < size; ++i) m.attacks[i] = 0ULL;
+
+        // carry-rippler over every subset of the mask
+        Bitboard sub = 0ULL;
+        do {
+            Bitboard att = bishop ? bishop_attacks_ray(sq, sub) : rook_attacks_ray(sq, sub);
+            Bitboard& slot = m.attacks[m.index(sub)];
+            if (slot && slot != att) return false;
+            slot = att;
+            sub = (sub - m.mask) & m.mask;
+        } while (sub);
+    }
+    return true;
+}
 
 void init_attack_tables() {
+    bool ok = fill_magics(bishop_magics, true);
+    ok = fill_magics(rook_magics, false) && ok;
+    assert(ok);
+    (void)ok;
+    assert(verify_slider_tables());
+}
+
+bool verify_slider_tables() {
     for (int sq = 0; sq < 64; ++sq) {
-        int f = f_of(sq), r = r_of(sq);
-
-        // pawn attacks
-        pawn_attacks[WHITE][sq] = 0ULL;
-        pawn_attacks[BLACK][sq] = 0ULL;
-
-        if (on_board(f - 1, r + 1)) pawn_attacks[WHITE][sq] |= bb_of(mk_sq(f - 1, r + 1));
-        if (on_board(f + 1, r + 1)) pawn_attacks[WHITE][sq] |= bb_of(mk_sq(f + 1, r + 1));
-        if (on_board(f - 1, r - 1)) pawn_attacks[BLACK][sq] |= bb_of(mk_sq(f - 1, r - 1));
-        if (on_board(f + 1, r - 1)) pawn_attacks[BLACK][sq] |= bb_of(mk_sq(f + 1, r - 1));
-
-        // knight
-        knight_attacks[sq] = 0ULL;
-        const int kdf[8] = {+1,+2,+2,+1,-1,-2,-2,-1};
-        const int kdr[8] = {+2,+1,-1,-2,-2,-1,+1,+2};
-        for (int i = 0; i < 8; ++i) {
-            int nf = f + kdf[i], nr = r + kdr[i];
-            if (on_board(nf, nr)) knight_attacks[sq] |= bb_of(mk_sq(nf, nr));
-        }
-
-        // king
-        king_attacks[sq] = 0ULL;
-        for (int df = -1; df <= 1; ++df) {
-            for (int dr = -1; dr <= 1; ++dr) {
-                if (df == 0 && dr == 0) continue;
-                int nf = f + df, nr = r + dr;
-                if (on_board(nf, nr)) king_attacks[sq] |= bb_of(mk_sq(nf, nr));
-            }
-        }
+        const Magic& b = bishop_magics[sq];
+        Bitboard sub = 0ULL;
+        do {
+            if (bishop_attacks(sq, sub) != bishop_attacks_ray(sq, sub)) return false;
+            sub = (sub - b.mask) & b.mask;
+        } while (sub);
+
+        const Magic& r = rook_magics[sq];
+        sub = 0ULL;
+        do {
+            if (rook_attacks(sq, sub) != rook_attacks_ray(sq, sub)) return false;
+            sub = (sub - r.mask) & r.mask;
+        } while (sub);
     }
+    return true;
 }
 
-Bitboard bishop_attacks(Square sq, Bitboard occ) {
-    Bitboard attacks = 0ULL;
-    int f = f_of(sq), r = r_of(sq);
+// ---- set-wise attack maps ----
+//
+// each ray is a Kogge-Stone occluded fill: the generators flood along the ray through
+// empty squares in three doubling steps, then one more shift adds the blockers.
+// Mask drops the squares a shift wrapped onto from the far edge (~0 for N/S).
 
-    // NE
-    for (int nf = f + 1, nr = r + 1; on_board(nf, nr); ++nf, ++nr) {
-        Square s = mk_sq(nf, nr);
-        attacks |= bb_of(s);
-        if (occ & bb_of(s)) break;
-    }
-    // NW
-    for (int nf = f - 1, nr = r + 1; on_board(nf, nr); --nf, ++nr) {
-        Square s = mk_sq(nf, nr);
-        attacks |= bb_of(s);
-        if (occ & bb_of(s)) break;
-    }
-    // SE
-    for (int nf = f + 1, nr = r - 1; on_board(nf, nr); ++nf, --nr) {
-        Square s = mk_sq(nf, nr);
-        attacks |= bb_of(s);
-        if (occ & bb_of(s)) break;
-    }
-    // SW
-    for (int nf = f - 1, nr = r - 1; on_board(nf, nr); --nf, --nr) {
-        Square s = mk_sq(nf, nr);
-        attacks |= bb_of(s);
-        if (occ & bb_of(s)) break;
-    }
+static constexpr Bitboard NOT_A = ~FILE_A;
+static constexpr Bitboard NOT_H = ~FILE_H;
 
-    return attacks;
+template <int Shift>
+static inline Bitboard shift_by(Bitboard b) {
+    if constexpr (Shift > 0) return b << Shift;
+    else return b >> -Shift;
 }
 
-Bitboard rook_attacks(Square sq, Bitboard occ) {
-    Bitboard attacks = 0ULL;
-    int f = f_of(sq), r = r_of(sq);
+template <int Shift, Bitboard Mask>
+static inline Bitboard occluded_attacks(Bitboard gen, Bitboard empty) {
+    Bitboard pro = empty & Mask;
+    gen |= pro & shift_by<Shift>(gen);
+    pro &= shift_by<Shift>(pro);
+    gen |= pro & shift_by<2 * Shift>(gen);
+    pro &= shift_by<2 * Shift>(pro);
+    gen |= pro & shift_by<4 * Shift>(gen);
+    return shift_by<Shift>(gen) & Mask;
+}
 
-    // N
-    for (int nr = r + 1; nr < 8; ++nr) {
-        Square s = mk_sq(f, nr);
-        attacks |= bb_of(s);
-        if (occ & bb_of(s)) break;
-    }
-    // S
-    for (int nr = r - 1; nr >= 0; --nr) {
-        Square s = mk_sq(f, nr);
-        attacks |= bb_of(s);
-        if (occ & bb_of(s)) break;
-    }
-    // E
-    for (int nf = f + 1; nf < 8; ++nf) {
-        Square s = mk_sq(nf, r);
-        attacks |= bb_of(s);
-        if (occ & bb_of(s)) break;
-    }
-    // W
-    for (int nf = f - 1; nf >= 0; --nf) {
-        Square s = mk_sq(nf, r);
-        attacks |= bb_of(s);
-        if (occ & bb_of(s)) break;
-    }
+[[maybe_unused]] static inline Bitboard slider_attack_map_scalar(Bitboard diag, Bitboard orth, Bitboard occ) {
+    const Bitboard empty = ~occ;
+    return occluded_attacks< 8, ~0ULL>(orth, empty) | occluded_attacks<-8, ~0ULL>(orth, empty)
+         | occluded_attacks< 1, NOT_A>(orth, empty) | occluded_attacks<-1, NOT_H>(orth, empty)
+         | occluded_attacks< 9, NOT_A>(diag, empty) | occluded_attacks< 7, NOT_H>(diag, empty)
+         | occluded_attacks<-7, NOT_A>(diag, empty) | occluded_attacks<-9, NOT_H>(diag, empty);
+}
 
-    return attacks;
+#if ATTACK_FILL_SIMD == 2
+
+// four rays per vector: lanes are N, E, NE, NW for the left shifts and S, W, SW, SE for
+// the right shifts, so both halves share one shift vector {8, 1, 9, 7}
+template <bool Left>
+static inline __m256i occluded_attacks4(__m256i gen, __m256i empty, __m256i mask) {
+    const __m256i s1 = _mm256_set_epi64x(7, 9, 1, 8);
+    const __m256i s2 = _mm256_slli_epi64(s1, 1);
+    const __m256i s4 = _mm256_slli_epi64(s1, 2);
+    auto sh = [](__m256i b, __m256i s) { return Left ? _mm256_sllv_epi64(b, s) : _mm256_srlv_epi64(b, s); };
+
+    __m256i pro = _mm256_and_si256(empty, mask);
+    gen = _mm256_or_si256(gen, _mm256_and_si256(pro, sh(gen, s1)));
+    pro = _mm256_and_si256(pro, sh(pro, s1));
+    gen = _mm256_or_si256(gen, _mm256_and_si256(pro, sh(gen, s2)));
+    pro = _mm256_and_si256(pro, sh(pro, s2));
+    gen = _mm256_or_si256(gen, _mm256_and_si256(pro, sh(gen, s4)));
+    return _mm256_and_si256(sh(gen, s1), mask);
 }
 
-static inline Bitboard pawn_attack_map(const chess::Position& pos, chess::Color c) {
-    Bitboard pawns = pos.pieces[c][chess::PAWN];
-    Bitboard att = 0ULL;
-    while (pawns) {
-        int sq = chess::pop_lsb(pawns);     // however you pop bits
-        att |= chess::pawn_attacks[c][sq];
-    }
-    return att;
+static inline Bitboard slider_attack_map_avx2(Bitboard diag, Bitboard orth, Bitboard occ) {
+    const __m256i gen   = _mm256_set_epi64x(diag, diag, orth, orth);
+    const __m256i empty = _mm256_set1_epi64x(~occ);
+    const __m256i left_mask  = _mm256_set_epi64x(NOT_H, NOT_A, NOT_A, ~0ULL);
+    const __m256i right_mask = _mm256_set_epi64x(NOT_A, NOT_H, NOT_H, ~0ULL);
+
+    const __m256i a = _mm256_or_si256(occluded_attacks4<true>(gen, empty, left_mask),
+                                      occluded_attacks4<false>(gen, empty, right_mask));
+    const __m128i h = _mm_or_si128(_mm256_castsi256_si128(a), _mm256_extracti128_si256(a, 1));
+    return Bitboard(_mm_cvtsi128_si64(h)) | Bitboard(_mm_cvtsi128_si64(_mm_unpackhi_epi64(h, h)));
+}
+
+#elif ATTACK_FILL_SIMD == 1
+
+// SSE2 only shifts both lanes by the same count, so the lanes are the two colours
+// and the eight rays run one after another
+template <int Shift>
+static inline __m128i shift_by2(__m128i b) {
+    if constexpr (Shift > 0) return _mm_slli_epi64(b, Shift);
+    else return _mm_srli_epi64(b, -Shift);
+}
+
+template <int Shift, Bitboard Mask>
+static inline __m128i occluded_attacks2(__m128i gen, __m128i empty) {
+    const __m128i mask = _mm_set1_epi64x((long long)Mask);
+    __m128i pro = _mm_and_si128(empty, mask);
+    gen = _mm_or_si128(gen, _mm_and_si128(pro, shift_by2<Shift>(gen)));
+    pro = _mm_and_si128(pro, shift_by2<Shift>(pro));
+    gen = _mm_or_si128(gen, _mm_and_si128(pro, shift_by2<2 * Shift>(gen)));
+    pro = _mm_and_si128(pro, shift_by2<2 * Shift>(pro));
+    gen = _mm_or_si128(gen, _mm_and_si128(pro, shift_by2<4 * Shift>(gen)));
+    return _mm_and_si128(shift_by2<Shift>(gen), mask);
+}
+
+static inline void slider_attack_maps_sse2(const Bitboard diag[2], const Bitboard orth[2], Bitboard occ, Bitboard out[2]) {
+    const __m128i d = _mm_set_epi64x((long long)diag[1], (long long)diag[0]);
+    const __m128i o = _mm_set_epi64x((long long)orth[1], (long long)orth[0]);
+    const __m128i empty = _mm_set1_epi64x((long long)~occ);
+
+    __m128i a = _mm_or_si128(occluded_attacks2< 8, ~0ULL>(o, empty), occluded_attacks2<-8, ~0ULL>(o, empty));
+    a = _mm_or_si128(a, _mm_or_si128(occluded_attacks2< 1, NOT_A>(o, empty), occluded_attacks2<-1, NOT_H>(o, empty)));
+    a = _mm_or_si128(a, _mm_or_si128(occluded_attacks2< 9, NOT_A>(d, empty), occluded_attacks2< 7, NOT_H>(d, empty)));
+    a = _mm_or_si128(a, _mm_or_si128(occluded_attacks2<-7, NOT_A>(d, empty), occluded_attacks2<-9, NOT_H>(d, empty)));
+
+    out[WHITE] = Bitboard(_mm_cvtsi128_si64(a));
+    out[BLACK] = Bitboard(_mm_cvtsi128_si64(_mm_unpackhi_epi64(a, a)));
 }
 
+#endif
+
+Bitboard slider_attack_map(Bitboard diag, Bitboard orth, Bitboard occ) {
+#if ATTACK_FILL_SIMD == 2
+    return slider_attack_map_avx2(diag, orth, occ);
+#else
+    return slider_attack_map_scalar(diag, orth, occ);
+#endif
+}
+
+// everything but the sliders
+static inline Bitboard step_attack_map(const Position& pos, Color c) {
+    return pawn_attack_map(pos, c)
+         | knight_attack_map(pos.pieces[c][KNIGHT])
+         | king_attacks[pos.king_square(c)];
+}
+
+Bitboard attack_map(const Position& pos, Color c) {
+    const Bitboard q = pos.pieces[c][QUEEN];
+    return step_attack_map(pos, c)
+         | slider_attack_map(pos.pieces[c][BISHOP] | q, pos.pieces[c][ROOK] | q, pos.occupied());
+}
+
+void attack_maps(const Position& pos, Bitboard out[2]) {
+#if ATTACK_FILL_SIMD == 1
+    const Bitboard diag[2] = { pos.pieces[WHITE][BISHOP] | pos.pieces[WHITE][QUEEN],
+                               pos.pieces[BLACK][BISHOP] | pos.pieces[BLACK][QUEEN] };
+    const Bitboard orth[2] = { pos.pieces[WHITE][ROOK] | pos.pieces[WHITE][QUEEN],
+                               pos.pieces[BLACK][ROOK] | pos.pieces[BLACK][QUEEN] };
+    slider_attack_maps_sse2(diag, orth, pos.occupied(), out);
+    out[WHITE] |= step_attack_map(pos, WHITE);
+    out[BLACK] |= step_attack_map(pos, BLACK);
+#else
+    out[WHITE] = attack_map(pos, WHITE);
+    out[BLACK] = attack_map(pos, BLACK);
+#endif
+}
 
 } // namespace chess
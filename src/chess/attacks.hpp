@@ -6,17 +6,244 @@
 
 namespace chess {
 
-extern Bitboard pawn_attacks[2][64];
-extern Bitboard knight_attacks[64];
-extern Bitboard king_attacks[64];
+// fancy magic entry: attacks = table[((occ & mask) * magic) >> shift]
+struct Magic {
+    Bitboard  mask;
+    Bitboard  magic;
+    Bitboard* attacks; // points into the shared slider table
+    unsigned  shift;
 
+    inline unsigned index(Bitboard occ) const {
+        return unsigned(((occ & mask) * magic) >> shift);
+    }
+};
+
+// ---------------- compile-time table builders ----------------
+// everything below is evaluated by the compiler and lands in read-only data,
+// except the slider attack payload, which init_attack_tables() fills (too large for constexpr limits)
+
+namespace detail {
+
+constexpr bool on_board(int f, int r) { return f >= 0 && f < 8 && r >= 0 && r < 8; }
+
+// walk from sq by (df, dr) until the edge or the first blocker in occ (blocker included)
+constexpr Bitboard slide(Square sq, int df, int dr, Bitboard occ) {
+    Bitboard attacks = 0ULL;
+    for (int f = f_of(sq) + df, r = r_of(sq) + dr; on_board(f, r); f += df, r += dr) {
+        attacks |= bb_of(mk_sq(f, r));
+        if (occ & bb_of(mk_sq(f, r))) break;
+    }
+    return attacks;
+}
+
+// one step from sq along each (df[i], dr[i])
+template <int N>
+constexpr Bitboard leap(Square sq, const int (&df)[N], const int (&dr)[N]) {
+    Bitboard attacks = 0ULL;
+    for (int i = 0; i < N; ++i) {
+        int f = f_of(sq) + df[i], r = r_of(sq) + dr[i];
+        if (on_board(f, r)) attacks |= bb_of(mk_sq(f, r));
+    }
+    return attacks;
+}
+
+struct LeaperTables {
+    Bitboard pawn[2][64];
+    Bitboard knight[64];
+    Bitboard king[64];
+};
+
+constexpr LeaperTables make_leaper_tables() {
+    constexpr int wp_df[2] = {-1, +1}, wp_dr[2] = {+1, +1};
+    constexpr int bp_df[2] = {-1, +1}, bp_dr[2] = {-1, -1};
+    constexpr int n_df[8] = {+1, +2, +2, +1, -1, -2, -2, -1};
+    constexpr int n_dr[8] = {+2, +1, -1, -2, -2, -1, +1, +2};
+    constexpr int k_df[8] = {-1, 0, +1, -1, +1, -1, 0, +1};
+    constexpr int k_dr[8] = {-1, -1, -1, 0, 0, +1, +1, +1};
+
+    LeaperTables t{};
+    for (int sq = 0; sq < 64; ++sq) {
+        t.pawn[WHITE][sq] = leap(sq, wp_df, wp_dr);
+        t.pawn[BLACK][sq] = leap(sq, bp_df, bp_dr);
+        t.knight[sq] = leap(sq, n_df, n_dr);
+        t.king[sq] = leap(sq, k_df, k_dr);
+    }
+    return t;
+}
+
+struct LineTables {
+    Bitboard between[64][64];
+    Bitboard line[64][64];
+};
+
+constexpr LineTables make_line_tables() {
+    LineTables t{};
+    for (int a = 0; a < 64; ++a) {
+        for (int b = 0; b < 64; ++b) {
+            const int df = f_of(b) - f_of(a), dr = r_of(b) - r_of(a);
+            if (a == b || !(df == 0 || dr == 0 || df == dr || df == -dr)) continue;
+
+            const int sf = (df > 0) - (df < 0), sr = (dr > 0) - (dr < 0);
+            t.between[a][b] = slide(a, sf, sr, bb_of(b)) & ~bb_of(b);
+            t.line[a][b] = slide(a, sf, sr, 0ULL) | slide(a, -sf, -sr, 0ULL) | bb_of(a);
+        }
+    }
+    return t;
+}
+
+// magics found offline for shift = 64 - popcount(mask); any collision is caught by init_attack_tables()
+inline constexpr Bitboard BISHOP_MAGIC[64] = {
+    0x0020428400408200ULL, 0x2008010104210004ULL, 0x02d0009200480190ULL, 0x0018158b00010100ULL,
+    0x02c4042132048008ULL, 0x020082202000c221ULL, 0x4000421050080009ULL, 0x0210140202022020ULL,
+    0x00c0101410042248ULL, 0x0405204800d48080ULL, 0x3800c89200420002ULL, 0x180844124a020440ULL,
+    0x04403410a8002221ULL, 0x4040209004200400ULL, 0x084004020202a204ULL, 0x3010002104022000ULL,
+    0x00200240a9110900ULL, 0x2302800404080210ULL, 0x0204188800240010ULL, 0x8048000c01401200ULL,
+    0x120c001a11040900ULL, 0x0000401200500440ULL, 0x00004040840420a0ULL, 0x0020930822880804ULL,
+    0x4044401090900161ULL, 0x0034100015210804ULL, 0x8004100009010120ULL, 0x48c8080000820500ULL,
+    0x0080848004002000ULL, 0x0801004012005044ULL, 0x000080902c040400ULL, 0x0004009005004100ULL,
+    0x0b103010048a0200ULL, 0x8004100203181a00ULL, 0x0800140200100080ULL, 0x8401010800910040ULL,
+    0x0840010011290040ULL, 0x40100214202e1000ULL, 0x0842040040010840ULL, 0x0028010040010860ULL,
+    0x00080202a2051000ULL, 0x4200841008084204ULL, 0x0021120110000d02ULL, 0x48c1004208000084ULL,
+    0x0010088100414400ULL, 0x0021101000420580ULL, 0x0010040558401410ULL, 0x200c0c82a1050205ULL,
+    0x0011108820088000ULL, 0x0001011910120402ULL, 0x1580008608091248ULL, 0x8010018020880c02ULL,
+    0x20a1101032088480ULL, 0x0080100408082800ULL, 0x28100401140401c0ULL, 0x8002102200930012ULL,
+    0x4001040082080200ULL, 0x082200a498081808ULL, 0x000508610080d003ULL, 0x0052020044842402ULL,
+    0x4800a00140c84840ULL, 0x5000000848080820ULL, 0x0101086004240040ULL, 0x0028280808005014ULL
+};
+
+inline constexpr Bitboard ROOK_MAGIC[64] = {
+    0x008000908064c000ULL, 0x0040200040001000ULL, 0x0180100080a0010aULL, 0x8880041000800800ULL,
+    0x1200100201200804ULL, 0x0200020004011008ULL, 0x2180010000800600ULL, 0x0200005088210204ULL,
+    0x0400800040008021ULL, 0x0400400020005000ULL, 0x8240801000200080ULL, 0x8611001004200900ULL,
+    0x008180800c001800ULL, 0x0100800200800400ULL, 0x0a02000102000408ULL, 0x8020802300104280ULL,
+    0x0080004000402000ULL, 0xe010104000402000ULL, 0x0800808010002000ULL, 0xa280210008100100ULL,
+    0x0001818014000800ULL, 0xa002010100080400ULL, 0x0080240001020870ULL, 0x0001020004048845ULL,
+    0x0081826280004004ULL, 0x2020810900284000ULL, 0x0200100080802000ULL, 0x0200080080100080ULL,
+    0x8083080100100500ULL, 0x4406000901000400ULL, 0x0005020080800100ULL, 0x0090204200008114ULL,
+    0x0010400094800420ULL, 0x0900804000802002ULL, 0x0201001841002000ULL, 0x4100080080801000ULL,
+    0x4540040080800800ULL, 0x0002001004040020ULL, 0x0281195814001002ULL, 0x1240800040800100ULL,
+    0x0880042000524004ULL, 0x02c080410206002cULL, 0x0801200241050010ULL, 0x8400080010008080ULL,
+    0x0008000500090010ULL, 0x0082009084020008ULL, 0x4012000108020004ULL, 0x9000104d08860004ULL,
+    0x2004204114800100ULL, 0x0148802112400300ULL, 0x0202842000100880ULL, 0x001b080080900080ULL,
+    0x001a002008100600ULL, 0x0004008004020080ULL, 0x5181000600040300ULL, 0x0000044401128a00ULL,
+    0x8044110480002441ULL, 0x2008110084402202ULL, 0x90806005090010c1ULL, 0x000420310a004a42ULL,
+    0x0023001004020801ULL, 0x0882001008040102ULL, 0x000230088118020cULL, 0x0000019025040042ULL
+};
+
+// shared attack storage for both slider types (fancy magics: 5248 bishop + 102400 rook entries)
+inline Bitboard slider_table[5248 + 102400];
+
+// relevant occupancy: the open ray minus the board edge it runs into
+constexpr Bitboard slider_mask(Square sq, bool bishop) {
+    const Bitboard edges = ((RANK_1 | RANK_8) & ~(RANK_1 << (8 * r_of(sq))))
+                         | ((FILE_A | FILE_H) & ~(FILE_A << f_of(sq)));
+    const Bitboard rays = bishop
+        ? slide(sq, 1, 1, 0ULL) | slide(sq, -1, 1, 0ULL) | slide(sq, 1, -1, 0ULL) | slide(sq, -1, -1, 0ULL)
+        : slide(sq, 0, 1, 0ULL) | slide(sq, 0, -1, 0ULL) | slide(sq, 1, 0, 0ULL) | slide(sq, -1, 0, 0ULL);
+    return rays & ~edges;
+}
+
+struct MagicTables {
+    Magic bishop[64];
+    Magic rook[64];
+};
+
+constexpr MagicTables make_magic_tables() {
+    MagicTables t{};
+    Bitboard* next = slider_table;
+    for (int sq = 0; sq < 64; ++sq) {
+        Magic& m = t.bishop[sq];
+        m.mask = slider_mask(sq, true);
+        m.magic = BISHOP_MAGIC[sq];
+        m.shift = 64 - popcount(m.mask);
+        m.attacks = next;
+        next += std::size_t(1) << popcount(m.mask);
+    }
+    for (int sq = 0; sq < 64; ++sq) {
+        Magic& m = t.rook[sq];
+        m.mask = slider_mask(sq, false);
+        m.magic = ROOK_MAGIC[sq];
+        m.shift = 64 - popcount(m.mask);
+        m.attacks = next;
+        next += std::size_t(1) << popcount(m.mask);
+    }
+    return t;
+}
+
+inline constexpr LeaperTables LEAPERS = make_leaper_tables();
+inline constexpr LineTables   LINES   = make_line_tables();
+inline constexpr MagicTables  MAGICS  = make_magic_tables();
+
+} // namespace detail
+
+inline constexpr const Bitboard (&pawn_attacks)[2][64] = detail::LEAPERS.pawn;
+inline constexpr const Bitboard (&knight_attacks)[64]  = detail::LEAPERS.knight;
+inline constexpr const Bitboard (&king_attacks)[64]    = detail::LEAPERS.king;
+
+// between_bb[a][b]: squares strictly between a and b on a shared rank/file/diagonal (else 0)
+// line_bb[a][b]:    the full line through a and b, endpoints included (else 0)
+inline constexpr const Bitboard (&between_bb)[64][64] = detail::LINES.between;
+inline constexpr const Bitboard (&line_bb)[64][64]    = detail::LINES.line;
+
+inline constexpr const Magic (&bishop_magics)[64] = detail::MAGICS.bishop;
+inline constexpr const Magic (&rook_magics)[64]   = detail::MAGICS.rook;
+
+// fills the magic attack payload; must run once before any slider lookup.
+// every other table above is compile-time data.
 void init_attack_tables();
 
-// sliders (ray-based)
-Bitboard bishop_attacks(Square sq, Bitboard occ);
-Bitboard rook_attacks(Square sq, Bitboard occ);
+// set-wise pawn attacks: every square attacked by the pawns in `pawns` of color c
+inline Bitboard pawn_attack_map(Bitboard pawns, Color c) {
+    return (c == WHITE) ? n_shift(e_shift(pawns) | w_shift(pawns))
+                        : s_shift(e_shift(pawns) | w_shift(pawns));
+}
+inline Bitboard pawn_attack_map(const Position& pos, Color c) {
+    return pawn_attack_map(pos.pieces[c][PAWN], c);
+}
+
+// set-wise knight attacks: every square attacked by a knight in `knights`
+inline Bitboard knight_attack_map(Bitboard knights) {
+    const Bitboard l1 = (knights >> 1) & ~FILE_H, l2 = (knights >> 2) & ~(FILE_G | FILE_H);
+    const Bitboard r1 = (knights << 1) & ~FILE_A, r2 = (knights << 2) & ~(FILE_A | FILE_B);
+    const Bitboard h1 = l1 | r1, h2 = l2 | r2;
+    return (h1 << 16) | (h1 >> 16) | (h2 << 8) | (h2 >> 8);
+}
+
+// set-wise slider attacks (Kogge-Stone occluded fill): every square attacked by a
+// diagonal slider in `diag` or an orthogonal slider in `orth`, all eight rays at once.
+// AVX2 builds run four rays per vector, the rest use the scalar fill
+Bitboard slider_attack_map(Bitboard diag, Bitboard orth, Bitboard occ);
+
+// whole-side attack maps (pawns, knights, sliders, king) for eval terms that only need
+// the union; attack_maps fills out[WHITE] and out[BLACK] together (SSE2 runs both
+// colours in the two lanes of one vector)
+Bitboard attack_map(const Position& pos, Color c);
+void attack_maps(const Position& pos, Bitboard out[2]);
+
+// sliders (magic lookup)
+inline Bitboard bishop_attacks(Square sq, Bitboard occ) {
+    const Magic& m = bishop_magics[sq];
+    return m.attacks[m.index(occ)];
+}
+inline Bitboard rook_attacks(Square sq, Bitboard occ) {
+    const Magic& m = rook_magics[sq];
+    return m.attacks[m.index(occ)];
+}
 inline Bitboard queen_attacks(Square sq, Bitboard occ) {
     return bishop_attacks(sq, occ) | rook_attacks(sq, occ);
 }
 
+// sliders (ray-based reference; used to build and validate the magic tables)
+constexpr Bitboard bishop_attacks_ray(Square sq, Bitboard occ) {
+    return detail::slide(sq, 1, 1, occ) | detail::slide(sq, -1, 1, occ)
+         | detail::slide(sq, 1, -1, occ) | detail::slide(sq, -1, -1, occ);
+}
+constexpr Bitboard rook_attacks_ray(Square sq, Bitboard occ) {
+    return detail::slide(sq, 0, 1, occ) | detail::slide(sq, 0, -1, occ)
+         | detail::slide(sq, 1, 0, occ) | detail::slide(sq, -1, 0, occ);
+}
+
+// compares magic lookups against the ray walkers for every relevant occupancy
+bool verify_slider_tables();
+
 } // namespace chess
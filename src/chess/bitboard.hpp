@@ -3,7 +3,7 @@
 #include "types.hpp"
 
 namespace chess {
-inline int popcount(Bitboard b) {
+constexpr int popcount(Bitboard b) {
     return __builtin_popcountll(b);
 }
 
@@ -43,4 +43,18 @@ inline Bitboard e_shift(Bitboard b) {
 inline Bitboard w_shift(Bitboard b) {
     return (b & ~FILE_A) >> 1;
 }
+
+// b plus every square north (south) of it on the same file
+inline Bitboard north_fill(Bitboard b) {
+    b |= b << 8;
+    b |= b << 16;
+    b |= b << 32;
+    return b;
+}
+inline Bitboard south_fill(Bitboard b) {
+    b |= b >> 8;
+    b |= b >> 16;
+    b |= b >> 32;
+    return b;
+}
 } //namespace chess
\ No newline at end of file
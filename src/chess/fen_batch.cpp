@@ -0,0 +1,136 @@
+#include "fen_batch.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string_view>
+#include <thread>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define FEN_BATCH_MMAP 1
+#endif
+
+namespace chess {
+
+// read-only view of a whole file: mmap where available, else a heap copy
+class FileView {
+public:
+    explicit FileView(const std::string& path) {
+#if FEN_BATCH_MMAP
+        const int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd >= 0) {
+            struct stat st;
+            if (::fstat(fd, &st) == 0) {
+                if (st.st_size == 0) {
+                    ok_ = true;
+                } else {
+                    void* p = ::mmap(nullptr, std::size_t(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+                    if (p != MAP_FAILED) {
+                        map_ = p;
+                        data_ = std::string_view(static_cast<const char*>(p), std::size_t(st.st_size));
+                        ::madvise(p, data_.size(), MADV_SEQUENTIAL);
+                        ok_ = true;
+                    }
+                }
+            }
+            ::close(fd);
+            if (ok_) return;
+        }
+#endif
+        std::ifstream in(path, std::ios::binary);
+        if (!in) return;
+        copy_.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+        data_ = copy_;
+        ok_ = true;
+    }
+
+    ~FileView() {
+#if FEN_BATCH_MMAP
+        if (map_) ::munmap(map_, data_.size());
+#endif
+    }
+
+    FileView(const FileView&) = delete;
+    FileView& operator=(const FileView&) = delete;
+
+    bool ok() const { return ok_; }
+    std::string_view data() const { return data_; }
+
+private:
+    void* map_ = nullptr;
+    std::string copy_;
+    std::string_view data_;
+    bool ok_ = false;
+};
+
+// the FEN part of a line: EPD opcodes cut off, surrounding blanks trimmed; empty for comments
+static std::string_view fen_part(std::string_view line) {
+    const std::size_t semi = line.find(';');
+    if (semi != std::string_view::npos) line = line.substr(0, semi);
+
+    const std::size_t b = line.find_first_not_of(" \t\r");
+    if (b == std::string_view::npos || line[b] == '#') return {};
+    const std::size_t e = line.find_last_not_of(" \t\r");
+    return line.substr(b, e - b + 1);
+}
+
+FenBatchResult load_fen_file(const std::string& path, std::vector<Position>& out, int threads) {
+    FenBatchResult res;
+    FileView file(path);
+    if (!file.ok()) return res;
+    res.opened = true;
+
+    // pass 1: split into candidate lines
+    const std::string_view text = file.data();
+    std::vector<std::string_view> lines;
+    for (std::size_t pos = 0; pos < text.size();) {
+        const char* nl = static_cast<const char*>(std::memchr(text.data() + pos, '\n', text.size() - pos));
+        const std::size_t end = nl ? std::size_t(nl - text.data()) : text.size();
+        const std::string_view fen = fen_part(text.substr(pos, end - pos));
+        if (!fen.empty()) lines.push_back(fen);
+        pos = end + 1;
+    }
+    res.lines = lines.size();
+    if (lines.empty()) return res;
+
+    // pass 2: parse contiguous chunks in parallel straight into the output slots
+    const std::size_t base = out.size();
+    out.resize(base + lines.size());
+    std::vector<char> good(lines.size(), 0);
+
+    int n = threads > 0 ? threads : int(std::max(1u, std::thread::hardware_concurrency()));
+    n = int(std::min<std::size_t>(std::size_t(n), lines.size()));
+    const std::size_t chunk = (lines.size() + std::size_t(n) - 1) / std::size_t(n);
+
+    auto work = [&](std::size_t begin, std::size_t end) {
+        for (std::size_t i = begin; i < end; ++i)
+            good[i] = out[base + i].parse_fen(lines[i]) == FenError::OK;
+    };
+
+    if (n == 1) {
+        work(0, lines.size());
+    } else {
+        std::vector<std::thread> pool;
+        pool.reserve(std::size_t(n));
+        for (std::size_t begin = 0; begin < lines.size(); begin += chunk)
+            pool.emplace_back(work, begin, std::min(lines.size(), begin + chunk));
+        for (std::thread& t : pool) t.join();
+    }
+
+    // drop failures, keeping file order
+    std::size_t w = base;
+    for (std::size_t i = 0; i < lines.size(); ++i) {
+        if (!good[i]) { res.failed++; continue; }
+        if (w != base + i) out[w] = out[base + i];
+        ++w;
+    }
+    out.resize(w);
+    return res;
+}
+
+} // namespace chess
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "position.hpp"
+
+namespace chess {
+
+struct FenBatchResult {
+    bool opened = false;     // false if the file could not be read at all
+    std::size_t lines = 0;   // non-empty, non-comment lines seen
+    std::size_t failed = 0;  // lines that did not parse (left out of the output)
+};
+
+// memory-maps a FEN/EPD file and parses one position per line across `threads` workers
+// (0 = hardware concurrency). EPD opcodes after the first ';' are dropped, blank lines
+// and '#' comments are skipped. positions are appended to `out` in file order.
+FenBatchResult load_fen_file(const std::string& path, std::vector<Position>& out, int threads = 0);
+
+} // namespace chess
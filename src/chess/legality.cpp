@@ -1,5 +1,7 @@
 #include "legality.hpp"
 
+#include <algorithm>
+
 namespace chess {
 
 bool is_square_attacked(const Position& pos, Square sq, Color by) {
@@ -27,4 +29,208 @@ bool is_square_attacked(const Position& pos, Square sq, Color by) {
     return false;
 }
 
+Bitboard attackers_to(const Position& pos, Square sq, Bitboard occ) {
+    const Bitboard bq = pos.pieces[WHITE][BISHOP] | pos.pieces[BLACK][BISHOP]
+                      | pos.pieces[WHITE][QUEEN]  | pos.pieces[BLACK][QUEEN];
+    const Bitboard rq = pos.pieces[WHITE][ROOK]   | pos.pieces[BLACK][ROOK]
+                      | pos.pieces[WHITE][QUEEN]  | pos.pieces[BLACK][QUEEN];
+
+    return (pawn_attacks[BLACK][sq] & pos.pieces[WHITE][PAWN])
+         | (pawn_attacks[WHITE][sq] & pos.pieces[BLACK][PAWN])
+         | (knight_attacks[sq] & (pos.pieces[WHITE][KNIGHT] | pos.pieces[BLACK][KNIGHT]))
+         | (king_attacks[sq] & (pos.pieces[WHITE][KING] | pos.pieces[BLACK][KING]))
+         | (bishop_attacks(sq, occ) & bq)
+         | (rook_attacks(sq, occ) & rq);
+}
+
+// least valuable piece of `side` in `set`; returns its bit (0 if none) and type
+static inline Bitboard least_valuable(const Position& pos, Bitboard set, Color side, PieceType& pt) {
+    for (int p = PAWN; p <= KING; ++p) {
+        Bitboard b = set & pos.pieces[side][p];
+        if (b) {
+            pt = (PieceType)p;
+            return b & (0ULL - b);
+        }
+    }
+    pt = NO_PIECE_TYPE;
+    return 0ULL;
+}
+
+// once a piece leaves the exchange square's lines, sliders behind it join in
+static inline Bitboard add_xrays(const Position& pos, Square sq, Bitboard occ, PieceType moved) {
+    Bitboard a = 0ULL;
+    if (moved == PAWN || moved == BISHOP || moved == QUEEN) {
+        a |= bishop_attacks(sq, occ) & (pos.pieces[WHITE][BISHOP] | pos.pieces[BLACK][BISHOP]
+                                      | pos.pieces[WHITE][QUEEN]  | pos.pieces[BLACK][QUEEN]);
+    }
+    if (moved == ROOK || moved == QUEEN) {
+        a |= rook_attacks(sq, occ) & (pos.pieces[WHITE][ROOK]  | pos.pieces[BLACK][ROOK]
+                                    | pos.pieces[WHITE][QUEEN] | pos.pieces[BLACK][QUEEN]);
+    }
+    return a;
+}
+
+static inline int captured_value(const Position& pos, Move m) {
+    if (flags(m) & EP) return SEE_VALUE[PAWN];
+    if (flags(m) & CAPTURE_MOVE) return SEE_VALUE[pos.piece_type_on(to(m))];
+    return 0;
+}
+
+static inline Bitboard exchange_occupancy(const Position& pos, Move m) {
+    const Square f = from(m);
+    const Square t = to(m);
+    Bitboard occ = pos.occ[OCC_BOTH] ^ bb_of(f);
+    if (flags(m) & EP) occ ^= bb_of(pos.stm == WHITE ? t - 8 : t + 8);
+    return occ;
+}
+
+int see(const Position& pos, Move m) {
+    if (flags(m) & CASTLE) return 0;
+
+    const Square t = to(m);
+    int gain[32];
+    int d = 0;
+
+    gain[0] = captured_value(pos, m);
+
+    PieceType attacker = pos.piece_type_on(from(m));
+    Bitboard occ = exchange_occupancy(pos, m);
+    Bitboard attackers = attackers_to(pos, t, occ) & occ;
+    Color side = ~pos.stm;
+
+    // swap list: gain[d] is the score for the side making capture d if the exchange stops there
+    while (d < 31) {
+        ++d;
+        gain[d] = SEE_VALUE[attacker] - gain[d - 1];
+
+        PieceType next;
+        Bitboard fromSet = least_valuable(pos, attackers, side, next);
+        if (!fromSet) break;
+
+        occ ^= fromSet;
+        attackers = (attackers | add_xrays(pos, t, occ, next)) & occ;
+        attacker = next;
+        side = ~side;
+    }
+
+    while (--d) gain[d - 1] = -std::max(-gain[d - 1], gain[d]);
+    return gain[0];
+}
+
+bool see_ge(const Position& pos, Move m, int threshold) {
+    if (flags(m) & CASTLE) return 0 >= threshold;
+
+    const Square t = to(m);
+
+    int swap = captured_value(pos, m) - threshold;
+    if (swap < 0) return false;
+
+    PieceType moved = pos.piece_type_on(from(m));
+    swap = SEE_VALUE[moved] - swap;
+    if (swap <= 0) return true;
+
+    Bitboard occ = exchange_occupancy(pos, m);
+    Bitboard attackers = attackers_to(pos, t, occ);
+    Color side = pos.stm;
+    int res = 1;
+
+    while (true) {
+        side = ~side;
+        attackers &= occ;
+
+        Bitboard mine = attackers & pos.occ[side];
+        if (!mine) break;
+
+        res ^= 1;
+
+        PieceType pt;
+        Bitboard fromSet = least_valuable(pos, mine, side, pt);
+
+        // a king can only recapture if the other side has nothing left to hit back with
+        if (pt == KING) {
+            return (attackers & ~pos.occ[side]) ? (res ^ 1) : res;
+        }
+
+        swap = SEE_VALUE[pt] - swap;
+        if (swap < res) break;
+
+        occ ^= fromSet;
+        attackers |= add_xrays(pos, t, occ, pt);
+    }
+
+    return res != 0;
+}
+
+CheckInfo check_info(const Position& pos) {
+    const Color us = pos.stm;
+    const Color them = ~us;
+    const Bitboard occ = pos.occ[OCC_BOTH];
+
+    CheckInfo ci;
+    ci.ksq = pos.king_square(them);
+
+    ci.check_sq[PAWN]   = pawn_attacks[them][ci.ksq];
+    ci.check_sq[KNIGHT] = knight_attacks[ci.ksq];
+    ci.check_sq[BISHOP] = bishop_attacks(ci.ksq, occ);
+    ci.check_sq[ROOK]   = rook_attacks(ci.ksq, occ);
+    ci.check_sq[QUEEN]  = ci.check_sq[BISHOP] | ci.check_sq[ROOK];
+    ci.check_sq[KING]   = 0ULL;
+
+    Bitboard snipers = (rook_attacks(ci.ksq, 0ULL) & (pos.pieces[us][ROOK] | pos.pieces[us][QUEEN]))
+                     | (bishop_attacks(ci.ksq, 0ULL) & (pos.pieces[us][BISHOP] | pos.pieces[us][QUEEN]));
+    while (snipers) {
+        Square s = pop_lsb(snipers);
+        Bitboard blockers = between_bb[ci.ksq][s] & occ;
+        if (blockers && !(blockers & (blockers - 1))) ci.discoverers |= blockers & pos.occ[us];
+    }
+    return ci;
+}
+
+bool gives_check(const Position& pos, Move m, const CheckInfo& ci) {
+    const Color us = pos.stm;
+    const Square f = from(m);
+    const Square t = to(m);
+    const uint32_t fl = flags(m);
+    const Bitboard occ = pos.occ[OCC_BOTH];
+
+    // direct check (the moving piece is never between itself and ksq, so the
+    // check squares computed on the current occupancy stay valid)
+    const PieceType pt = pos.piece_type_on(f);
+    if (!(fl & (PROMO | CASTLE)) && (ci.check_sq[pt] & bb_of(t))) return true;
+
+    // discovered check: a blocker steps off the line to the enemy king
+    if ((ci.discoverers & bb_of(f)) && !(line_bb[ci.ksq][f] & bb_of(t))) return true;
+
+    if (fl & PROMO) {
+        const Bitboard occ2 = occ ^ bb_of(f);
+        switch ((PieceType)promo(m)) {
+            case KNIGHT: return (knight_attacks[t] & bb_of(ci.ksq)) != 0ULL;
+            case BISHOP: return (bishop_attacks(t, occ2) & bb_of(ci.ksq)) != 0ULL;
+            case ROOK:   return (rook_attacks(t, occ2) & bb_of(ci.ksq)) != 0ULL;
+            case QUEEN:  return (queen_attacks(t, occ2) & bb_of(ci.ksq)) != 0ULL;
+            default:     return false;
+        }
+    }
+
+    if (fl & CASTLE) {
+        // only the rook can check; the king's vacated square may open its rank
+        const bool kingSide = f_of(t) == 6;
+        const Square rf = mk_sq(kingSide ? 7 : 0, r_of(f));
+        const Square rt = mk_sq(kingSide ? 5 : 3, r_of(f));
+        const Bitboard occ2 = (occ ^ bb_of(f) ^ bb_of(rf)) | bb_of(t) | bb_of(rt);
+        return (rook_attacks(rt, occ2) & bb_of(ci.ksq)) != 0ULL;
+    }
+
+    if (fl & EP) {
+        // the captured pawn leaves too, which can uncover a slider on the rank or diagonal
+        const Square cap = (us == WHITE) ? (t - 8) : (t + 8);
+        const Bitboard occ2 = (occ ^ bb_of(f) ^ bb_of(cap)) | bb_of(t);
+        const Bitboard bq = pos.pieces[us][BISHOP] | pos.pieces[us][QUEEN];
+        const Bitboard rq = pos.pieces[us][ROOK] | pos.pieces[us][QUEEN];
+        return ((bishop_attacks(ci.ksq, occ2) & bq) | (rook_attacks(ci.ksq, occ2) & rq)) != 0ULL;
+    }
+
+    return false;
+}
+
 } // namespace chess
@@ -2,15 +2,43 @@
 
 #include "position.hpp"
 #include "attacks.hpp"
+#include "move.hpp"
 
 namespace chess {
 
 bool is_square_attacked(const Position& pos, Square sq, Color by);
 
+// every piece of either color attacking sq, with sliders seen through `occ`
+Bitboard attackers_to(const Position& pos, Square sq, Bitboard occ);
+
+// static exchange evaluation (centipawns, from the mover's side; pins ignored)
+constexpr int SEE_VALUE[7] = {100, 320, 330, 500, 900, 20000, 0}; // PAWN..KING, NO_PIECE_TYPE
+
+int see(const Position& pos, Move m);
+bool see_ge(const Position& pos, Move m, int threshold);
+
+// per-node data for answering "does this move give check?" without making it
+struct CheckInfo {
+    Square   ksq = NO_SQUARE;     // enemy king
+    Bitboard check_sq[6]{};       // squares from which each of our piece types would hit ksq
+    Bitboard discoverers = 0ULL;  // our pieces that are the only blocker between our slider and ksq
+};
+
+CheckInfo check_info(const Position& pos);
+bool gives_check(const Position& pos, Move m, const CheckInfo& ci);
+inline bool gives_check(const Position& pos, Move m) {
+    return gives_check(pos, m, check_info(pos));
+}
+
 inline bool in_check(const Position& pos, Color c) {
     Square ksq = pos.king_square(c);
     if (ksq == NO_SQUARE) return false;
     return is_square_attacked(pos, ksq, ~c);
 }
 
+// side to move in check, from the checkers cached by set_fen/do_move
+inline bool in_check(const Position& pos) {
+    return pos.checkers != 0ULL;
+}
+
 } // namespace chess
@@ -1,106 +1,155 @@
 #include "make.hpp"
+#include "zobrist.hpp"
+
+#include <cassert>
 
 namespace chess {
 
-static inline Square A1() { return mk_sq(0,0); }
-static inline Square H1() { return mk_sq(7,0); }
-static inline Square E1() { return mk_sq(4,0); }
-static inline Square A8() { return mk_sq(0,7); }
-static inline Square H8() { return mk_sq(7,7); }
-static inline Square E8() { return mk_sq(4,7); }
-static inline Square F1() { return mk_sq(5,0); }
-static inline Square G1() { return mk_sq(6,0); }
-static inline Square D1() { return mk_sq(3,0); }
-static inline Square C1() { return mk_sq(2,0); }
-static inline Square F8() { return mk_sq(5,7); }
-static inline Square G8() { return mk_sq(6,7); }
-static inline Square D8() { return mk_sq(3,7); }
-static inline Square C8() { return mk_sq(2,7); }
-static inline Square B1() { return mk_sq(1,0); }
-static inline Square B8() { return mk_sq(1,7); }
+static constexpr Square A1() { return mk_sq(0,0); }
+static constexpr Square H1() { return mk_sq(7,0); }
+static constexpr Square E1() { return mk_sq(4,0); }
+static constexpr Square A8() { return mk_sq(0,7); }
+static constexpr Square H8() { return mk_sq(7,7); }
+static constexpr Square E8() { return mk_sq(4,7); }
+static constexpr Square F1() { return mk_sq(5,0); }
+static constexpr Square G1() { return mk_sq(6,0); }
+static constexpr Square D1() { return mk_sq(3,0); }
+static constexpr Square C1() { return mk_sq(2,0); }
+static constexpr Square F8() { return mk_sq(5,7); }
+static constexpr Square G8() { return mk_sq(6,7); }
+static constexpr Square D8() { return mk_sq(3,7); }
+static constexpr Square C8() { return mk_sq(2,7); }
+static constexpr Square B1() { return mk_sq(1,0); }
+static constexpr Square B8() { return mk_sq(1,7); }
 
+// occupancies are kept in step with XOR deltas instead of being rebuilt from the piece boards
 static inline void remove_piece(Position& pos, Color c, PieceType pt, Square sq) {
-    pos.pieces[c][pt] &= ~bb_of(sq);
+    const Bitboard b = bb_of(sq);
+    pos.pieces[c][pt] ^= b;
+    pos.occ[c] ^= b;
+    pos.occ[OCC_BOTH] ^= b;
+    pos.board[sq] = NO_PIECE;
 }
 static inline void add_piece(Position& pos, Color c, PieceType pt, Square sq) {
-    pos.pieces[c][pt] |= bb_of(sq);
+    const Bitboard b = bb_of(sq);
+    pos.pieces[c][pt] |= b;
+    pos.occ[c] |= b;
+    pos.occ[OCC_BOTH] |= b;
+    pos.board[sq] = make_piece(c, pt);
 }
-
-static inline PieceType moving_piece_type(const Position& pos, Color c, Square fromSq) {
-    Bitboard m = bb_of(fromSq);
-    for (int p = 0; p < 6; ++p) if (pos.pieces[c][p] & m) return (PieceType)p;
-    return NO_PIECE_TYPE;
+static inline void move_piece(Position& pos, Color c, PieceType pt, Square f, Square t) {
+    const Bitboard ft = bb_of(f) | bb_of(t);
+    pos.pieces[c][pt] ^= ft;
+    pos.occ[c] ^= ft;
+    pos.occ[OCC_BOTH] ^= ft;
+    pos.board[t] = pos.board[f];
+    pos.board[f] = NO_PIECE;
 }
 
-static inline PieceType captured_piece_type(const Position& pos, Color c, Square toSq) {
-    Bitboard m = bb_of(toSq);
-    for (int p = 0; p < 6; ++p) if (pos.pieces[c][p] & m) return (PieceType)p;
-    return NO_PIECE_TYPE;
+static inline int ep_file_index(Square ep) {
+    return (ep == NO_SQUARE) ? 8 : f_of(ep);
 }
 
-static inline void update_castling_on_move(Position& pos, Color c, PieceType pt, Square fromSq) {
+template <Color Us>
+static inline void update_castling_on_move(Position& pos, PieceType pt, Square fromSq) {
+    constexpr bool White = (Us == WHITE);
+    constexpr Castling KingSide  = White ? WHITE_KING_SIDE  : BLACK_KING_SIDE;
+    constexpr Castling QueenSide = White ? WHITE_QUEEN_SIDE : BLACK_QUEEN_SIDE;
+    constexpr Square HRook = White ? H1() : H8();
+    constexpr Square ARook = White ? A1() : A8();
+
     // king move nukes both sides
-    if (pt == KING) {
-        if (c == WHITE) pos.castling_rights &= ~(WHITE_KING_SIDE | WHITE_QUEEN_SIDE);
-        else            pos.castling_rights &= ~(BLACK_KING_SIDE | BLACK_QUEEN_SIDE);
-    }
+    if (pt == KING) pos.castling_rights &= ~(KingSide | QueenSide);
     // rook move from corner nukes that side
     if (pt == ROOK) {
-        if (fromSq == H1()) pos.castling_rights &= ~WHITE_KING_SIDE;
-        if (fromSq == A1()) pos.castling_rights &= ~WHITE_QUEEN_SIDE;
-        if (fromSq == H8()) pos.castling_rights &= ~BLACK_KING_SIDE;
-        if (fromSq == A8()) pos.castling_rights &= ~BLACK_QUEEN_SIDE;
+        if (fromSq == HRook) pos.castling_rights &= ~KingSide;
+        if (fromSq == ARook) pos.castling_rights &= ~QueenSide;
     }
 }
 
-static inline void update_castling_on_capture(Position& pos, Color victim, Square capSq) {
+template <Color Victim>
+static inline void update_castling_on_capture(Position& pos, Square capSq) {
+    constexpr bool White = (Victim == WHITE);
+    constexpr Square HRook = White ? H1() : H8();
+    constexpr Square ARook = White ? A1() : A8();
+
     // capturing rook on corner nukes victim rights
-    if (capSq == H1()) pos.castling_rights &= ~WHITE_KING_SIDE;
-    if (capSq == A1()) pos.castling_rights &= ~WHITE_QUEEN_SIDE;
-    if (capSq == H8()) pos.castling_rights &= ~BLACK_KING_SIDE;
-    if (capSq == A8()) pos.castling_rights &= ~BLACK_QUEEN_SIDE;
+    if (capSq == HRook) pos.castling_rights &= ~(White ? WHITE_KING_SIDE  : BLACK_KING_SIDE);
+    if (capSq == ARook) pos.castling_rights &= ~(White ? WHITE_QUEEN_SIDE : BLACK_QUEEN_SIDE);
+}
+
+// rook hop for a castling move landing the king on t
+template <Color Us>
+static inline void castle_rook_squares(Square t, Square& rf, Square& rt) {
+    constexpr bool White = (Us == WHITE);
+    if (t == (White ? G1() : G8())) { rf = White ? H1() : H8(); rt = White ? F1() : F8(); } // king side
+    else                            { rf = White ? A1() : A8(); rt = White ? D1() : D8(); } // queen side
 }
 
-Undo do_move(Position& pos, Move m) {
-    Undo u;
-    u.castling_rights = pos.castling_rights;
-    u.en_passant_square = pos.en_passant_square;
-    u.halfmove_clock = pos.halfmove_clock;
-    u.fullmove_number = pos.fullmove_number;
-    u.captured = false;
-    u.cap_pt = NO_PIECE_TYPE;
-    u.cap_sq = NO_SQUARE;
+// enemy pieces checking Them's king once Us has moved (kings never give check)
+template <Color Us>
+static inline Bitboard checkers_of(const Position& pos) {
+    constexpr Color Them = ~Us;
+    const Square ksq = pos.king_square(Them);
+    const Bitboard occ = pos.occ[OCC_BOTH];
+    const Bitboard* ours = pos.pieces[Us];
+
+    return (pawn_attacks[Them][ksq] & ours[PAWN])
+         | (knight_attacks[ksq] & ours[KNIGHT])
+         | (bishop_attacks(ksq, occ) & (ours[BISHOP] | ours[QUEEN]))
+         | (rook_attacks(ksq, occ) & (ours[ROOK] | ours[QUEEN]));
+}
+
+template <Color Us>
+static void do_move_t(Position& pos, Move m, StateInfo& st) {
+    constexpr Color Them = ~Us;
+    constexpr int Push = (Us == WHITE) ? 8 : -8;
+
+    st.key = pos.key;
+    st.pawn_key = pos.pawn_key;
+    st.material_key = pos.material_key;
+    st.checkers = pos.checkers;
+    st.en_passant_square = pos.en_passant_square;
+    st.halfmove_clock = pos.halfmove_clock;
+    st.fullmove_number = pos.fullmove_number;
+    st.castling_rights = pos.castling_rights;
+    st.captured = NO_PIECE;
 
     const Square f = from(m);
     const Square t = to(m);
     const uint32_t fl = flags(m);
     const uint32_t pr = promo(m);
 
-    Color us = pos.stm;
-    Color them = ~us;
+    // key: drop the old EP file and rights now, fold in the new ones at the end
+    std::uint64_t k = pos.key;
+    k ^= ZB.ep_file[ep_file_index(pos.en_passant_square)];
+    k ^= ZB.castling[pos.castling_rights & 15];
 
     // clear EP by default; set later if DPUSH
     pos.en_passant_square = NO_SQUARE;
 
     // find moving piece type
-    PieceType pt = moving_piece_type(pos, us, f);
+    PieceType pt = pos.piece_type_on(f);
 
     // capture handling
     if (fl & EP) {
         // EP capture: target square is empty; captured pawn is behind it
-        u.captured = true;
-        u.cap_pt = PAWN;
-        u.cap_sq = (us == WHITE) ? (t - 8) : (t + 8);
-        remove_piece(pos, them, PAWN, u.cap_sq);
-        update_castling_on_capture(pos, them, u.cap_sq); // harmless, but ok
+        st.captured = make_piece(Them, PAWN);
+        remove_piece(pos, Them, PAWN, t - Push);
+        k ^= ZB.piece[Them][PAWN][t - Push];
+        pos.pawn_key ^= ZB.piece[Them][PAWN][t - Push];
+        pos.material_key ^= ZB.material[Them][PAWN][popcount(pos.pieces[Them][PAWN])];
         pos.halfmove_clock = 0;
     } else if (fl & CAPTURE_MOVE) {
-        PieceType cpt = captured_piece_type(pos, them, t);
-        u.captured = true;
-        u.cap_pt = cpt;
-        u.cap_sq = t;
-        if (cpt != NO_PIECE_TYPE) remove_piece(pos, them, cpt, t);
-        update_castling_on_capture(pos, them, t);
+        PieceType cpt = pos.piece_type_on(t);
+        if (cpt != NO_PIECE_TYPE) {
+            st.captured = make_piece(Them, cpt);
+            remove_piece(pos, Them, cpt, t);
+            k ^= ZB.piece[Them][cpt][t];
+            if (cpt == PAWN) pos.pawn_key ^= ZB.piece[Them][PAWN][t];
+            pos.material_key ^= ZB.material[Them][cpt][popcount(pos.pieces[Them][cpt])];
+        }
+        update_castling_on_capture<Them>(pos, t);
         pos.halfmove_clock = 0;
     }
 
@@ -108,125 +157,130 @@ Undo do_move(Position& pos, Move m) {
     if (pt == PAWN) pos.halfmove_clock = 0;
     else if (!(fl & CAPTURE_MOVE) && !(fl & EP)) pos.halfmove_clock += 1;
 
-    // move piece (promotion/castling special)
-    remove_piece(pos, us, pt, f);
-
     if (fl & CASTLE) {
         // king lands on t, rook moves too
-        add_piece(pos, us, KING, t);
-
-        if (us == WHITE) {
-            if (t == G1()) { // king side
-                remove_piece(pos, WHITE, ROOK, H1());
-                add_piece(pos, WHITE, ROOK, F1());
-            } else { // queen side -> C1
-                remove_piece(pos, WHITE, ROOK, A1());
-                add_piece(pos, WHITE, ROOK, D1());
-            }
-        } else {
-            if (t == G8()) {
-                remove_piece(pos, BLACK, ROOK, H8());
-                add_piece(pos, BLACK, ROOK, F8());
-            } else { // C8
-                remove_piece(pos, BLACK, ROOK, A8());
-                add_piece(pos, BLACK, ROOK, D8());
-            }
-        }
+        move_piece(pos, Us, KING, f, t);
+        k ^= ZB.piece[Us][KING][f] ^ ZB.piece[Us][KING][t];
+
+        Square rf, rt;
+        castle_rook_squares<Us>(t, rf, rt);
+        move_piece(pos, Us, ROOK, rf, rt);
+        k ^= ZB.piece[Us][ROOK][rf] ^ ZB.piece[Us][ROOK][rt];
 
         // castling always kills your castling rights
-        update_castling_on_move(pos, us, KING, f);
+        update_castling_on_move<Us>(pos, KING, f);
     }
     else if (fl & PROMO) {
         // promo field: we assume pr is PieceType (KNIGHT..QUEEN). you can enforce.
         PieceType newpt = (PieceType)pr;
-        add_piece(pos, us, newpt, t);
+        remove_piece(pos, Us, PAWN, f);
+        add_piece(pos, Us, newpt, t);
+        k ^= ZB.piece[Us][PAWN][f] ^ ZB.piece[Us][newpt][t];
+        pos.pawn_key ^= ZB.piece[Us][PAWN][f];
+        pos.material_key ^= ZB.material[Us][PAWN][popcount(pos.pieces[Us][PAWN])]
+                          ^ ZB.material[Us][newpt][popcount(pos.pieces[Us][newpt]) - 1];
     }
     else {
         // normal move
-        add_piece(pos, us, pt, t);
+        move_piece(pos, Us, pt, f, t);
+        k ^= ZB.piece[Us][pt][f] ^ ZB.piece[Us][pt][t];
+        if (pt == PAWN) pos.pawn_key ^= ZB.piece[Us][PAWN][f] ^ ZB.piece[Us][PAWN][t];
 
         if (fl & DPUSH) {
             // set EP square (the square jumped over)
-            pos.en_passant_square = (us == WHITE) ? (f + 8) : (f - 8);
+            pos.en_passant_square = f + Push;
         }
 
-        update_castling_on_move(pos, us, pt, f);
+        update_castling_on_move<Us>(pos, pt, f);
     }
 
     // update move number / side
-    if (us == BLACK) pos.fullmove_number += 1;
-    pos.stm = them;
+    if (Us == BLACK) pos.fullmove_number += 1;
+    pos.stm = Them;
+
+    k ^= ZB.ep_file[ep_file_index(pos.en_passant_square)];
+    k ^= ZB.castling[pos.castling_rights & 15];
+    k ^= ZB.side;
+    pos.key = k;
+
+    pos.checkers = checkers_of<Us>(pos);
 
-    pos.update_occ();
-    return u;
+    assert(pos.key == compute_key(pos));
+    assert(pos.pawn_key == compute_pawn_key(pos));
+    assert(pos.material_key == compute_material_key(pos));
+    assert(pos.checkers == (attackers_to(pos, pos.king_square(Them), pos.occ[OCC_BOTH]) & pos.occ[Us]));
 }
 
-void undo_move(Position& pos, Move m, const Undo& u) {
+template <Color Us>
+static void undo_move_t(Position& pos, Move m, const StateInfo& st) {
+    constexpr Color Them = ~Us;
+    constexpr int Push = (Us == WHITE) ? 8 : -8;
+
     const Square f = from(m);
     const Square t = to(m);
     const uint32_t fl = flags(m);
     const uint32_t pr = promo(m);
 
     // restore clocks/rights/ep/stm/fullmove
-    pos.stm = ~pos.stm;
-    pos.castling_rights = u.castling_rights;
-    pos.en_passant_square = u.en_passant_square;
-    pos.halfmove_clock = u.halfmove_clock;
-    pos.fullmove_number = u.fullmove_number;
-
-    Color us = pos.stm;
-    Color them = ~us;
+    pos.stm = Us;
+    pos.castling_rights = st.castling_rights;
+    pos.en_passant_square = st.en_passant_square;
+    pos.halfmove_clock = st.halfmove_clock;
+    pos.fullmove_number = st.fullmove_number;
+    pos.key = st.key;
+    pos.pawn_key = st.pawn_key;
+    pos.material_key = st.material_key;
+    pos.checkers = st.checkers;
 
     // undo piece movement
     if (fl & CASTLE) {
         // move king back, restore rook
-        remove_piece(pos, us, KING, t);
-        add_piece(pos, us, KING, f);
-
-        if (us == WHITE) {
-            if (t == G1()) {
-                remove_piece(pos, WHITE, ROOK, F1());
-                add_piece(pos, WHITE, ROOK, H1());
-            } else {
-                remove_piece(pos, WHITE, ROOK, D1());
-                add_piece(pos, WHITE, ROOK, A1());
-            }
-        } else {
-            if (t == G8()) {
-                remove_piece(pos, BLACK, ROOK, F8());
-                add_piece(pos, BLACK, ROOK, H8());
-            } else {
-                remove_piece(pos, BLACK, ROOK, D8());
-                add_piece(pos, BLACK, ROOK, A8());
-            }
-        }
+        move_piece(pos, Us, KING, t, f);
+
+        Square rf, rt;
+        castle_rook_squares<Us>(t, rf, rt);
+        move_piece(pos, Us, ROOK, rt, rf);
     }
     else if (fl & PROMO) {
         // remove promoted piece at t, put pawn back at f
         PieceType newpt = (PieceType)pr;
-        remove_piece(pos, us, newpt, t);
-        add_piece(pos, us, PAWN, f);
+        remove_piece(pos, Us, newpt, t);
+        add_piece(pos, Us, PAWN, f);
     }
     else {
         // normal piece moved back
-        PieceType pt = moving_piece_type(pos, us, t);
-        remove_piece(pos, us, pt, t);
-        add_piece(pos, us, pt, f);
+        move_piece(pos, Us, pos.piece_type_on(t), t, f);
     }
 
     // restore captured piece if any
-    if (u.captured && u.cap_sq != NO_SQUARE && u.cap_pt != NO_PIECE_TYPE) {
-        add_piece(pos, them, u.cap_pt, u.cap_sq);
+    if (st.captured != NO_PIECE) {
+        add_piece(pos, Them, type_of(st.captured), (fl & EP) ? t - Push : t);
     }
+}
+
+void do_move(Position& pos, Move m, StateInfo& st) {
+    if (pos.stm == WHITE) do_move_t<WHITE>(pos, m, st);
+    else                  do_move_t<BLACK>(pos, m, st);
+}
+
+void undo_move(Position& pos, Move m, const StateInfo& st) {
+    // stm is the side that made m once more after undo, i.e. the opposite of the current stm
+    if (pos.stm == BLACK) undo_move_t<WHITE>(pos, m, st);
+    else                  undo_move_t<BLACK>(pos, m, st);
+}
 
-    pos.update_occ();
+void do_move_copy(const Position& src, Position& dst, Move m) {
+    dst = src;
+    StateInfo discard; // nothing to restore: the caller keeps src
+    do_move(dst, m, discard);
 }
 
 bool is_legal_move(Position& pos, Move m) {
     Color us = pos.stm;
-    Undo u = do_move(pos, m);
+    StateInfo st;
+    do_move(pos, m, st);
     bool ok = !in_check(pos, us);
-    undo_move(pos, m, u);
+    undo_move(pos, m, st);
     return ok;
 }
 
@@ -6,20 +6,25 @@
 
 namespace chess {
 
-struct Undo {
-    uint8_t castling_rights;
+// per-ply state saved by do_move and restored by undo_move.
+// the searcher owns one per ply; everything else in Position is updated in place.
+struct StateInfo {
+    std::uint64_t key;
+    std::uint64_t pawn_key;
+    std::uint64_t material_key;
+    Bitboard checkers;
     Square en_passant_square;
-    int halfmove_clock;
-    int fullmove_number;
-
-    // capture restore
-    bool captured;
-    PieceType cap_pt;
-    Square cap_sq;
+    uint16_t halfmove_clock;
+    uint16_t fullmove_number;
+    uint8_t castling_rights;
+    Piece captured; // NO_PIECE unless m captured (square is to(m), or behind it for EP)
 };
 
-Undo do_move(Position& pos, Move m);
-void undo_move(Position& pos, Move m, const Undo& u);
+void do_move(Position& pos, Move m, StateInfo& st);
+void undo_move(Position& pos, Move m, const StateInfo& st);
+
+// copy-make: dst becomes src with m played, src is untouched (undo = drop dst)
+void do_move_copy(const Position& src, Position& dst, Move m);
 
 // legality = doesn’t leave your own king in check
 bool is_legal_move(Position& pos, Move m);
@@ -3,9 +3,22 @@
 #include "types.hpp"
 
 namespace chess {
-using Move = uint32_t;
+
+// 16-bit move: from (bits 0-5) | to (bits 6-11) | kind (bits 12-15)
+using Move = uint16_t;
 constexpr Move NO_MOVE = 0;
 
+// kind layout: bit 3 = promotion, bit 2 = capture; promotions keep the piece in bits 0-1
+enum MoveKind : uint32_t {
+    KIND_QUIET         = 0,
+    KIND_DPUSH         = 1,
+    KIND_CASTLE        = 2,
+    KIND_CAPTURE       = 4,
+    KIND_EP            = 5,
+    KIND_PROMO         = 8,  // + (piece - KNIGHT)
+    KIND_PROMO_CAPTURE = 12  // + (piece - KNIGHT)
+};
+
 enum MoveFlag : uint32_t {
     QUIET_MOVE      = 0,
     CAPTURE_MOVE    = 1 << 0,
@@ -15,12 +28,37 @@ enum MoveFlag : uint32_t {
     PROMO           = 1 << 4
 };
 
-inline Move make_move(Square from, Square to, uint32_t flags = 0, uint32_t promo = 0) {
-    return (from) | (to << 6) | (promo << 12) | (flags << 16);
+constexpr uint32_t kind_for(uint32_t flags, uint32_t promo) {
+    if (flags & PROMO) return ((flags & CAPTURE_MOVE) ? KIND_PROMO_CAPTURE : KIND_PROMO) | (promo - KNIGHT);
+    if (flags & EP)           return KIND_EP;
+    if (flags & CASTLE)       return KIND_CASTLE;
+    if (flags & CAPTURE_MOVE) return KIND_CAPTURE;
+    if (flags & DPUSH)        return KIND_DPUSH;
+    return KIND_QUIET;
 }
 
-inline Square from(Move m){return m & 0x3F;}
-inline Square to(Move m){return (m >> 6) & 0x3F;}
-inline uint32_t promo(Move m){return (m >> 12) & 0xF;}
-inline uint32_t flags(Move m){return (m >> 16);}
-}
\ No newline at end of file
+// flags and promo piece take the same values as before the move was packed into 16 bits
+constexpr Move make_move(Square from, Square to, uint32_t flags = 0, uint32_t promo = 0) {
+    return Move(from | (to << 6) | (kind_for(flags, promo) << 12));
+}
+
+constexpr Square from(Move m) { return m & 0x3F; }
+constexpr Square to(Move m) { return (m >> 6) & 0x3F; }
+constexpr uint32_t kind_of(Move m) { return m >> 12; }
+
+// cheap hot-path tests straight off the kind bits
+constexpr bool is_capture(Move m) { return kind_of(m) & KIND_CAPTURE; } // includes EP and capture-promotions
+constexpr bool is_promotion(Move m) { return kind_of(m) & KIND_PROMO; }
+
+// decode helpers for code that wants the full flag set
+inline constexpr uint32_t KIND_FLAGS[16] = {
+    QUIET_MOVE, DPUSH, CASTLE, QUIET_MOVE,
+    CAPTURE_MOVE, CAPTURE_MOVE | EP, QUIET_MOVE, QUIET_MOVE,
+    PROMO, PROMO, PROMO, PROMO,
+    PROMO | CAPTURE_MOVE, PROMO | CAPTURE_MOVE, PROMO | CAPTURE_MOVE, PROMO | CAPTURE_MOVE
+};
+
+constexpr uint32_t flags(Move m) { return KIND_FLAGS[kind_of(m)]; }
+constexpr uint32_t promo(Move m) { return is_promotion(m) ? KNIGHT + (kind_of(m) & 3) : 0; }
+
+}
@@ -1,161 +1,201 @@
 #include "movegen.hpp"
 
+#include <cassert>
+
 namespace chess {
 
-static inline Square A1() { return mk_sq(0,0); }
-static inline Square H1() { return mk_sq(7,0); }
-static inline Square E1() { return mk_sq(4,0); }
-static inline Square A8() { return mk_sq(0,7); }
-static inline Square H8() { return mk_sq(7,7); }
-static inline Square E8() { return mk_sq(4,7); }
-static inline Square F1() { return mk_sq(5,0); }
-static inline Square G1() { return mk_sq(6,0); }
-static inline Square D1() { return mk_sq(3,0); }
-static inline Square C1() { return mk_sq(2,0); }
-static inline Square F8() { return mk_sq(5,7); }
-static inline Square G8() { return mk_sq(6,7); }
-static inline Square D8() { return mk_sq(3,7); }
-static inline Square C8() { return mk_sq(2,7); }
-static inline Square B1() { return mk_sq(1,0); }
-static inline Square B8() { return mk_sq(1,7); }
-
-static inline void push_move(std::vector<Move>& out, Square f, Square t, uint32_t fl=0, uint32_t pr=0) {
-    out.push_back(make_move(f, t, fl, pr));
-}
-
-static inline void gen_pawns(const Position& pos, std::vector<Move>& out, Color us) {
-    Color them = ~us;
-    Bitboard pawns = pos.pieces[us][PAWN];
+static constexpr Square A1() { return mk_sq(0,0); }
+static constexpr Square H1() { return mk_sq(7,0); }
+static constexpr Square E1() { return mk_sq(4,0); }
+static constexpr Square A8() { return mk_sq(0,7); }
+static constexpr Square H8() { return mk_sq(7,7); }
+static constexpr Square E8() { return mk_sq(4,7); }
+static constexpr Square F1() { return mk_sq(5,0); }
+static constexpr Square G1() { return mk_sq(6,0); }
+static constexpr Square D1() { return mk_sq(3,0); }
+static constexpr Square C1() { return mk_sq(2,0); }
+static constexpr Square F8() { return mk_sq(5,7); }
+static constexpr Square G8() { return mk_sq(6,7); }
+static constexpr Square D8() { return mk_sq(3,7); }
+static constexpr Square C8() { return mk_sq(2,7); }
+static constexpr Square B1() { return mk_sq(1,0); }
+static constexpr Square B8() { return mk_sq(1,7); }
+
+static inline void push_move(MoveList& out, Square f, Square t, uint32_t fl=0, uint32_t pr=0) {
+    out.push(make_move(f, t, fl, pr));
+}
+
+// generation stage: NOISY = captures, EP and all promotions; QUIET = everything else
+enum GenType { GEN_NOISY, GEN_QUIET, GEN_ALL };
+
+// legality masks for the side to move, computed once per node.
+// pseudo-legal generation uses the permissive defaults (no pins, every square a target).
+struct MoveMasks {
+    Square   ksq = NO_SQUARE;
+    Bitboard checkers = 0ULL;
+    Bitboard pinned = 0ULL;
+    Bitboard target = ~0ULL; // destinations that resolve a check (everything when not in check)
+    Bitboard stage = ~0ULL;  // piece destinations allowed by the stage (enemy / empty / all)
+    GenType  type = GEN_ALL;
+    bool     legal = false;
+};
+
+// squares a piece on f may move to without exposing its own king
+static inline Bitboard pin_ray(const MoveMasks& mm, Square f) {
+    return (mm.pinned & bb_of(f)) ? line_bb[mm.ksq][f] : ~0ULL;
+}
+
+static inline Bitboard attackers_by(const Position& pos, Square sq, Color by, Bitboard occ) {
+    return (pawn_attacks[~by][sq] & pos.pieces[by][PAWN])
+         | (knight_attacks[sq] & pos.pieces[by][KNIGHT])
+         | (king_attacks[sq] & pos.pieces[by][KING])
+         | (bishop_attacks(sq, occ) & (pos.pieces[by][BISHOP] | pos.pieces[by][QUEEN]))
+         | (rook_attacks(sq, occ) & (pos.pieces[by][ROOK] | pos.pieces[by][QUEEN]));
+}
+
+template <Color Us>
+static inline Bitboard pinned_pieces(const Position& pos, Square ksq) {
+    constexpr Color Them = ~Us;
     Bitboard occB = pos.occ[OCC_BOTH];
-    Bitboard theirOcc = pos.occ[them];
-
-    while (pawns) {
-        Square f = pop_lsb(pawns);
-        int r = r_of(f);
-
-        if (us == WHITE) {
-            Square one = f + 8;
-            if (one < 64 && (occB & bb_of(one)) == 0ULL) {
-                // promotion?
-                if (r == 6) {
-                    push_move(out, f, one, PROMO, KNIGHT);
-                    push_move(out, f, one, PROMO, BISHOP);
-                    push_move(out, f, one, PROMO, ROOK);
-                    push_move(out, f, one, PROMO, QUEEN);
-                } else {
-                    push_move(out, f, one, QUIET_MOVE);
-                    // double push
-                    if (r == 1) {
-                        Square two = f + 16;
-                        if ((occB & bb_of(two)) == 0ULL)
-                            push_move(out, f, two, DPUSH);
-                    }
-                }
-            }
-
-            // captures
-            Bitboard caps = pawn_attacks[WHITE][f] & theirOcc;
-            while (caps) {
-                Square t = pop_lsb(caps);
-                if (r == 6) {
-                    push_move(out, f, t, CAPTURE_MOVE | PROMO, KNIGHT);
-                    push_move(out, f, t, CAPTURE_MOVE | PROMO, BISHOP);
-                    push_move(out, f, t, CAPTURE_MOVE | PROMO, ROOK);
-                    push_move(out, f, t, CAPTURE_MOVE | PROMO, QUEEN);
-                } else {
-                    push_move(out, f, t, CAPTURE_MOVE);
-                }
-            }
-
-            // en passant
-            if (pos.en_passant_square != NO_SQUARE) {
-                Bitboard epMask = bb_of(pos.en_passant_square);
-                if (pawn_attacks[WHITE][f] & epMask) {
-                    push_move(out, f, pos.en_passant_square, CAPTURE_MOVE | EP);
-                }
-            }
-
-        } else { // BLACK
-            Square one = f - 8;
-            if (one >= 0 && (occB & bb_of(one)) == 0ULL) {
-                if (r == 1) {
-                    push_move(out, f, one, PROMO, KNIGHT);
-                    push_move(out, f, one, PROMO, BISHOP);
-                    push_move(out, f, one, PROMO, ROOK);
-                    push_move(out, f, one, PROMO, QUEEN);
-                } else {
-                    push_move(out, f, one, QUIET_MOVE);
-                    if (r == 6) {
-                        Square two = f - 16;
-                        if ((occB & bb_of(two)) == 0ULL)
-                            push_move(out, f, two, DPUSH);
-                    }
-                }
-            }
-
-            Bitboard caps = pawn_attacks[BLACK][f] & theirOcc;
-            while (caps) {
-                Square t = pop_lsb(caps);
-                if (r == 1) {
-                    push_move(out, f, t, CAPTURE_MOVE | PROMO, KNIGHT);
-                    push_move(out, f, t, CAPTURE_MOVE | PROMO, BISHOP);
-                    push_move(out, f, t, CAPTURE_MOVE | PROMO, ROOK);
-                    push_move(out, f, t, CAPTURE_MOVE | PROMO, QUEEN);
-                } else {
-                    push_move(out, f, t, CAPTURE_MOVE);
-                }
-            }
-
-            if (pos.en_passant_square != NO_SQUARE) {
-                Bitboard epMask = bb_of(pos.en_passant_square);
-                if (pawn_attacks[BLACK][f] & epMask) {
-                    push_move(out, f, pos.en_passant_square, CAPTURE_MOVE | EP);
-                }
-            }
-        }
+
+    Bitboard snipers = (rook_attacks(ksq, 0ULL) & (pos.pieces[Them][ROOK] | pos.pieces[Them][QUEEN]))
+                     | (bishop_attacks(ksq, 0ULL) & (pos.pieces[Them][BISHOP] | pos.pieces[Them][QUEEN]));
+
+    Bitboard pinned = 0ULL;
+    while (snipers) {
+        Square s = pop_lsb(snipers);
+        Bitboard blockers = between_bb[ksq][s] & occB;
+        if (blockers && !(blockers & (blockers - 1))) pinned |= blockers & pos.occ[Us];
     }
+    return pinned;
 }
 
-static inline void gen_leapers(const Position& pos, std::vector<Move>& out, Color us, PieceType pt, const Bitboard* table) {
-    Color them = ~us;
-    Bitboard bb = pos.pieces[us][pt];
-    Bitboard ours = pos.occ[us];
-    Bitboard theirs = pos.occ[them];
+// EP removes two pawns from the same rank, so pin masks can't see every discovered check;
+// replay the capture on the occupancy instead
+template <Color Us>
+static inline bool ep_is_legal(const Position& pos, Square ksq, Square f, Square t) {
+    constexpr Color Them = ~Us;
+    constexpr int Push = (Us == WHITE) ? 8 : -8;
+    Square cap = t - Push;
+    Bitboard occ = (pos.occ[OCC_BOTH] ^ bb_of(f) ^ bb_of(cap)) | bb_of(t);
 
-    while (bb) {
-        Square f = pop_lsb(bb);
-        Bitboard atk = table[f] & ~ours;
+    Bitboard theirs = pos.occ[Them] & ~bb_of(cap);
+    return (attackers_by(pos, ksq, Them, occ) & theirs) == 0ULL;
+}
 
-        Bitboard caps = atk & theirs;
-        Bitboard quiets = atk & ~theirs;
+static inline void push_promos(MoveList& out, Square f, Square t, uint32_t fl) {
+    push_move(out, f, t, fl | PROMO, KNIGHT);
+    push_move(out, f, t, fl | PROMO, BISHOP);
+    push_move(out, f, t, fl | PROMO, ROOK);
+    push_move(out, f, t, fl | PROMO, QUEEN);
+}
 
-        while (quiets) {
-            Square t = pop_lsb(quiets);
-            push_move(out, f, t, QUIET_MOVE);
-        }
-        while (caps) {
-            Square t = pop_lsb(caps);
-            push_move(out, f, t, CAPTURE_MOVE);
+// a pinned piece may only move along the line through its king
+static inline bool leaves_pin_line(const MoveMasks& mm, Square f, Square t) {
+    return (mm.pinned & bb_of(f)) && !(line_bb[mm.ksq][f] & bb_of(t));
+}
+
+// serializes a set of pawn destinations; every move shares the same from->to offset
+static inline void serialize_pawns(MoveList& out, Bitboard targets, int delta, uint32_t fl, const MoveMasks& mm) {
+    while (targets) {
+        Square t = pop_lsb(targets);
+        Square f = t - delta;
+        if (leaves_pin_line(mm, f, t)) continue;
+        push_move(out, f, t, fl);
+    }
+}
+
+static inline void serialize_promos(MoveList& out, Bitboard targets, int delta, uint32_t fl, const MoveMasks& mm) {
+    while (targets) {
+        Square t = pop_lsb(targets);
+        Square f = t - delta;
+        if (leaves_pin_line(mm, f, t)) continue;
+        push_promos(out, f, t, fl);
+    }
+}
+
+// set-wise: all pushes/captures of every pawn come from whole-board shifts,
+// then each target set is serialized with a fixed offset
+template <Color Us>
+static inline void gen_pawns(const Position& pos, MoveList& out, const MoveMasks& mm) {
+    constexpr Color Them = ~Us;
+    constexpr int Push = (Us == WHITE) ? 8 : -8;
+    constexpr Bitboard PromoFrom = (Us == WHITE) ? RANK_7 : RANK_2;
+    constexpr Bitboard DPushVia = (Us == WHITE) ? RANK_3 : RANK_6; // single-push square of a double push
+
+    auto up = [](Bitboard b) { return (Us == WHITE) ? n_shift(b) : s_shift(b); };
+
+    Bitboard pawns = pos.pieces[Us][PAWN];
+    Bitboard empty = ~pos.occ[OCC_BOTH];
+    Bitboard theirOcc = pos.occ[Them];
+
+    Bitboard promoters = pawns & PromoFrom;
+    Bitboard others = pawns & ~PromoFrom;
+
+    // pushes: promotions are noisy, the rest quiet
+    if (mm.type != GEN_NOISY) {
+        Bitboard one = up(others) & empty;
+        Bitboard two = up(one & DPushVia) & empty & mm.target;
+        one &= mm.target;
+
+        serialize_pawns(out, one, Push, QUIET_MOVE, mm);
+        serialize_pawns(out, two, Push + Push, DPUSH, mm);
+    }
+
+    if (mm.type == GEN_QUIET) return;
+
+    // captures toward the west (file - 1) and east (file + 1)
+    const Bitboard capTargets = theirOcc & mm.target;
+
+    if (promoters) {
+        Bitboard pushP = up(promoters) & empty & mm.target;
+        Bitboard westP = up(w_shift(promoters)) & capTargets;
+        Bitboard eastP = up(e_shift(promoters)) & capTargets;
+
+        serialize_promos(out, pushP, Push, QUIET_MOVE, mm);
+        serialize_promos(out, westP, Push - 1, CAPTURE_MOVE, mm);
+        serialize_promos(out, eastP, Push + 1, CAPTURE_MOVE, mm);
+    }
+
+    Bitboard west = up(w_shift(others)) & capTargets;
+    Bitboard east = up(e_shift(others)) & capTargets;
+    serialize_pawns(out, west, Push - 1, CAPTURE_MOVE, mm);
+    serialize_pawns(out, east, Push + 1, CAPTURE_MOVE, mm);
+
+    // en passant
+    if (pos.en_passant_square != NO_SQUARE) {
+        Square t = pos.en_passant_square;
+        Bitboard takers = pawn_attacks[Them][t] & others;
+        while (takers) {
+            Square f = pop_lsb(takers);
+            if (!mm.legal || ep_is_legal<Us>(pos, mm.ksq, f, t))
+                push_move(out, f, t, CAPTURE_MOVE | EP);
         }
     }
 }
 
-static inline void gen_sliders(const Position& pos, std::vector<Move>& out, Color us, PieceType pt) {
-    Color them = ~us;
-    Bitboard bb = pos.pieces[us][pt];
-    Bitboard ours = pos.occ[us];
-    Bitboard theirs = pos.occ[them];
+template <Color Us, PieceType Pt>
+static inline void gen_pieces(const Position& pos, MoveList& out, const MoveMasks& mm) {
+    constexpr Color Them = ~Us;
+    Bitboard bb = pos.pieces[Us][Pt];
+    if (Pt == KNIGHT) bb &= ~mm.pinned; // a pinned knight can never move
+
+    Bitboard ours = pos.occ[Us];
+    Bitboard theirs = pos.occ[Them];
     Bitboard occB = pos.occ[OCC_BOTH];
 
     while (bb) {
         Square f = pop_lsb(bb);
-        Bitboard atk = 0ULL;
+        Bitboard atk;
 
-        if (pt == BISHOP) atk = bishop_attacks(f, occB);
-        else if (pt == ROOK) atk = rook_attacks(f, occB);
-        else if (pt == QUEEN) atk = queen_attacks(f, occB);
+        if constexpr (Pt == KNIGHT)      atk = knight_attacks[f];
+        else if constexpr (Pt == BISHOP) atk = bishop_attacks(f, occB);
+        else if constexpr (Pt == ROOK)   atk = rook_attacks(f, occB);
+        else if constexpr (Pt == QUEEN)  atk = queen_attacks(f, occB);
+        else                             atk = king_attacks[f];
 
-        atk &= ~ours;
+        atk &= ~ours & mm.target & mm.stage;
+        if constexpr (Pt != KNIGHT && Pt != KING) atk &= pin_ray(mm, f);
 
         Bitboard caps = atk & theirs;
         Bitboard quiets = atk & ~theirs;
@@ -171,69 +211,236 @@ static inline void gen_sliders(const Position& pos, std::vector<Move>& out, Colo
     }
 }
 
-static inline void gen_castles(const Position& pos, std::vector<Move>& out, Color us) {
+// king steps are checked against the enemy attack set with our king lifted off the board,
+// so stepping back along a checking ray is rejected too
+template <Color Us>
+static inline void gen_king_legal(const Position& pos, MoveList& out, const MoveMasks& mm) {
+    constexpr Color Them = ~Us;
+    Square ksq = mm.ksq;
+    Bitboard theirs = pos.occ[Them];
+    Bitboard occ = pos.occ[OCC_BOTH] ^ bb_of(ksq);
+    Bitboard atk = king_attacks[ksq] & ~pos.occ[Us] & mm.stage;
+
+    while (atk) {
+        Square t = pop_lsb(atk);
+        if (attackers_by(pos, t, Them, occ)) continue;
+        push_move(out, ksq, t, (theirs & bb_of(t)) ? CAPTURE_MOVE : QUIET_MOVE);
+    }
+}
+
+template <Color Us>
+static inline void gen_castles(const Position& pos, MoveList& out) {
+    constexpr Color Them = ~Us;
+    constexpr bool White = (Us == WHITE);
+    constexpr Castling KingSide  = White ? WHITE_KING_SIDE  : BLACK_KING_SIDE;
+    constexpr Castling QueenSide = White ? WHITE_QUEEN_SIDE : BLACK_QUEEN_SIDE;
+    constexpr Square KFrom = White ? E1() : E8();
+    constexpr Square B = White ? B1() : B8();
+    constexpr Square C = White ? C1() : C8();
+    constexpr Square D = White ? D1() : D8();
+    constexpr Square F = White ? F1() : F8();
+    constexpr Square G = White ? G1() : G8();
+
     // enforce “through check” here because legal-filtering alone isn’t sufficient for castling rules
-    if (us == WHITE) {
-        if (pos.castling_rights & WHITE_KING_SIDE) {
-            if (pos.empty(F1()) && pos.empty(G1())
-                && !in_check(pos, WHITE)
-                && !is_square_attacked(pos, F1(), BLACK)
-                && !is_square_attacked(pos, G1(), BLACK)) {
-                push_move(out, E1(), G1(), CASTLE);
-            }
-        }
-        if (pos.castling_rights & WHITE_QUEEN_SIDE) {
-            if (pos.empty(D1()) && pos.empty(C1()) && pos.empty(B1())
-                && !in_check(pos, WHITE)
-                && !is_square_attacked(pos, D1(), BLACK)
-                && !is_square_attacked(pos, C1(), BLACK)) {
-                push_move(out, E1(), C1(), CASTLE);
-            }
-        }
-    } else {
-        if (pos.castling_rights & BLACK_KING_SIDE) {
-            if (pos.empty(F8()) && pos.empty(G8())
-                && !in_check(pos, BLACK)
-                && !is_square_attacked(pos, F8(), WHITE)
-                && !is_square_attacked(pos, G8(), WHITE)) {
-                push_move(out, E8(), G8(), CASTLE);
-            }
+    if (pos.castling_rights & KingSide) {
+        if (pos.empty(F) && pos.empty(G)
+            && !in_check(pos, Us)
+            && !is_square_attacked(pos, F, Them)
+            && !is_square_attacked(pos, G, Them)) {
+            push_move(out, KFrom, G, CASTLE);
         }
-        if (pos.castling_rights & BLACK_QUEEN_SIDE) {
-            if (pos.empty(D8()) && pos.empty(C8()) && pos.empty(B8())
-                && !in_check(pos, BLACK)
-                && !is_square_attacked(pos, D8(), WHITE)
-                && !is_square_attacked(pos, C8(), WHITE)) {
-                push_move(out, E8(), C8(), CASTLE);
-            }
+    }
+    if (pos.castling_rights & QueenSide) {
+        if (pos.empty(D) && pos.empty(C) && pos.empty(B)
+            && !in_check(pos, Us)
+            && !is_square_attacked(pos, D, Them)
+            && !is_square_attacked(pos, C, Them)) {
+            push_move(out, KFrom, C, CASTLE);
         }
     }
 }
 
-void generate_pseudo_legal(const Position& pos, std::vector<Move>& out) {
-    Color us = pos.stm;
+template <Color Us>
+static void gen_pseudo(const Position& pos, MoveList& out) {
+    const MoveMasks mm{};
+
+    gen_pawns<Us>(pos, out, mm);
+    gen_pieces<Us, KNIGHT>(pos, out, mm);
+    gen_pieces<Us, BISHOP>(pos, out, mm);
+    gen_pieces<Us, ROOK>(pos, out, mm);
+    gen_pieces<Us, QUEEN>(pos, out, mm);
+    gen_pieces<Us, KING>(pos, out, mm);
+    gen_castles<Us>(pos, out);
+}
+
+// shared driver for the legal stages; pins are computed once here, checkers come cached on pos
+template <Color Us>
+static void gen_legal_stage(const Position& pos, MoveList& out, GenType type) {
+    constexpr Color Them = ~Us;
+
+    MoveMasks mm;
+    mm.legal = true;
+    mm.type = type;
+    if (type == GEN_NOISY) mm.stage = pos.occ[Them];
+    else if (type == GEN_QUIET) mm.stage = ~pos.occ[OCC_BOTH];
+
+    mm.ksq = pos.king_square(Us);
+    mm.checkers = pos.checkers;
+
+    gen_king_legal<Us>(pos, out, mm);
+
+    // double check: only the king may move
+    if (mm.checkers & (mm.checkers - 1)) return;
+
+    if (mm.checkers) {
+        // single check: capture the checker or block its ray
+        mm.target = between_bb[mm.ksq][lsb(mm.checkers)] | mm.checkers;
+    }
+    mm.pinned = pinned_pieces<Us>(pos, mm.ksq);
+
+    gen_pawns<Us>(pos, out, mm);
+    gen_pieces<Us, KNIGHT>(pos, out, mm);
+    gen_pieces<Us, BISHOP>(pos, out, mm);
+    gen_pieces<Us, ROOK>(pos, out, mm);
+    gen_pieces<Us, QUEEN>(pos, out, mm);
+    if (!mm.checkers && type != GEN_NOISY) gen_castles<Us>(pos, out);
+}
+
+static inline void gen_legal_stage(const Position& pos, MoveList& out, GenType type) {
+    if (pos.stm == WHITE) gen_legal_stage<WHITE>(pos, out, type);
+    else                  gen_legal_stage<BLACK>(pos, out, type);
+}
+
+void generate_pseudo_legal(const Position& pos, MoveList& out) {
+    if (pos.stm == WHITE) gen_pseudo<WHITE>(pos, out);
+    else                  gen_pseudo<BLACK>(pos, out);
+}
+
+void generate_legal(Position& pos, MoveList& out) {
+    gen_legal_stage(pos, out, GEN_ALL);
+}
+
+void generate_captures(const Position& pos, MoveList& out) {
+    gen_legal_stage(pos, out, GEN_NOISY);
+}
+
+void generate_quiets(const Position& pos, MoveList& out) {
+    gen_legal_stage(pos, out, GEN_QUIET);
+}
+
+void generate_evasions(const Position& pos, MoveList& out) {
+    assert(in_check(pos, pos.stm));
+    gen_legal_stage(pos, out, GEN_ALL);
+}
+
+// ---- legal move counting ----
+//
+// same masks as gen_legal_stage, but each piece adds popcount(destinations) instead of
+// serializing moves; promotions count four times. `Us` need not be the side to move
+// (eval asks for both colours), so checkers are recomputed and EP only counts for stm.
 
-    gen_pawns(pos, out, us);
-    gen_leapers(pos, out, us, KNIGHT, knight_attacks);
-    gen_sliders(pos, out, us, BISHOP);
-    gen_sliders(pos, out, us, ROOK);
-    gen_sliders(pos, out, us, QUEEN);
-    gen_leapers(pos, out, us, KING, king_attacks);
-    gen_castles(pos, out, us);
+template <Color Us>
+static inline int count_pawn_targets(Bitboard to) {
+    constexpr Bitboard PromoTo = (Us == WHITE) ? RANK_8 : RANK_1;
+    return popcount(to & ~PromoTo) + 4 * popcount(to & PromoTo);
 }
 
-void generate_legal(Position& pos, std::vector<Move>& out) {
-    std::vector<Move> pseudo;
-    pseudo.reserve(256);
-    generate_pseudo_legal(pos, pseudo);
+template <Color Us>
+static int count_legal(const Position& pos) {
+    constexpr Color Them = ~Us;
+    constexpr bool White = (Us == WHITE);
+    constexpr Bitboard DPushVia = White ? RANK_3 : RANK_6;
+
+    auto up = [](Bitboard b) { return White ? n_shift(b) : s_shift(b); };
+
+    const Square ksq = pos.king_square(Us);
+    const Bitboard occ = pos.occ[OCC_BOTH];
+    const Bitboard ours = pos.occ[Us];
+    const Bitboard theirs = pos.occ[Them];
+    const Bitboard checkers = (Us == pos.stm) ? pos.checkers : attackers_by(pos, ksq, Them, occ);
+
+    // enemy attacks with our king lifted, so stepping back along a checking ray is out
+    const Bitboard tq = pos.pieces[Them][QUEEN];
+    const Bitboard diag = pos.pieces[Them][BISHOP] | tq;
+    const Bitboard orth = pos.pieces[Them][ROOK] | tq;
+    const Bitboard occ_nk = occ ^ bb_of(ksq);
+    Bitboard danger = pawn_attack_map(pos, Them)
+                    | knight_attack_map(pos.pieces[Them][KNIGHT])
+                    | king_attacks[pos.king_square(Them)];
+#if defined(__AVX2__)
+    danger |= slider_attack_map(diag, orth, occ_nk);
+#else
+    // the scalar fill only beats one magic lookup per slider when AVX2 runs its rays
+    for (Bitboard b = diag; b; ) danger |= bishop_attacks(pop_lsb(b), occ_nk);
+    for (Bitboard b = orth; b; ) danger |= rook_attacks(pop_lsb(b), occ_nk);
+#endif
+
+    int n = popcount(king_attacks[ksq] & ~ours & ~danger);
+    if (checkers & (checkers - 1)) return n;
+
+    const Bitboard target = ~ours & (checkers ? (between_bb[ksq][lsb(checkers)] | checkers) : ~0ULL);
+    const Bitboard pinned = pinned_pieces<Us>(pos, ksq);
+
+    for (Bitboard b = pos.pieces[Us][KNIGHT] & ~pinned; b; ) {
+        n += popcount(knight_attacks[pop_lsb(b)] & target);
+    }
+    for (Bitboard b = pos.pieces[Us][BISHOP] | pos.pieces[Us][QUEEN]; b; ) {
+        const Square f = pop_lsb(b);
+        const Bitboard ray = (pinned & bb_of(f)) ? line_bb[ksq][f] : ~0ULL;
+        n += popcount(bishop_attacks(f, occ) & target & ray);
+    }
+    for (Bitboard b = pos.pieces[Us][ROOK] | pos.pieces[Us][QUEEN]; b; ) {
+        const Square f = pop_lsb(b);
+        const Bitboard ray = (pinned & bb_of(f)) ? line_bb[ksq][f] : ~0ULL;
+        n += popcount(rook_attacks(f, occ) & target & ray);
+    }
 
-    Color us = pos.stm;
-    for (Move m : pseudo) {
-        Undo u = do_move(pos, m);
-        bool ok = !in_check(pos, us);
-        undo_move(pos, m, u);
-        if (ok) out.push_back(m);
+    // unpinned pawns set-wise, pinned ones one at a time along their pin line
+    const Bitboard pawns = pos.pieces[Us][PAWN];
+    const Bitboard free = pawns & ~pinned;
+    {
+        const Bitboard one = up(free) & ~occ;
+        const Bitboard two = up(one & DPushVia) & ~occ;
+        n += count_pawn_targets<Us>(one & target) + popcount(two & target);
+        n += count_pawn_targets<Us>(up(w_shift(free)) & theirs & target);
+        n += count_pawn_targets<Us>(up(e_shift(free)) & theirs & target);
     }
+    for (Bitboard b = pawns & pinned; b; ) {
+        const Square f = pop_lsb(b);
+        const Bitboard one = up(bb_of(f)) & ~occ;
+        const Bitboard to = one | (up(one & DPushVia) & ~occ) | (pawn_attacks[Us][f] & theirs);
+        n += count_pawn_targets<Us>(to & target & line_bb[ksq][f]);
+    }
+
+    if (Us == pos.stm && pos.en_passant_square != NO_SQUARE) {
+        const Square t = pos.en_passant_square;
+        for (Bitboard b = pawn_attacks[Them][t] & pawns; b; ) {
+            if (ep_is_legal<Us>(pos, ksq, pop_lsb(b), t)) ++n;
+        }
+    }
+
+    if (!checkers) {
+        constexpr Castling KingSide  = White ? WHITE_KING_SIDE  : BLACK_KING_SIDE;
+        constexpr Castling QueenSide = White ? WHITE_QUEEN_SIDE : BLACK_QUEEN_SIDE;
+        constexpr Bitboard KsEmpty = White ? (bb_of(F1()) | bb_of(G1())) : (bb_of(F8()) | bb_of(G8()));
+        constexpr Bitboard QsEmpty = White ? (bb_of(B1()) | bb_of(C1()) | bb_of(D1()))
+                                           : (bb_of(B8()) | bb_of(C8()) | bb_of(D8()));
+        constexpr Bitboard QsSafe = White ? (bb_of(C1()) | bb_of(D1())) : (bb_of(C8()) | bb_of(D8()));
+
+        if ((pos.castling_rights & KingSide) && !(occ & KsEmpty) && !(danger & KsEmpty)) ++n;
+        if ((pos.castling_rights & QueenSide) && !(occ & QsEmpty) && !(danger & QsSafe)) ++n;
+    }
+
+    return n;
+}
+
+int count_legal_moves(const Position& pos, Color side) {
+    return (side == WHITE) ? count_legal<WHITE>(pos) : count_legal<BLACK>(pos);
+}
+
+Bitboard pinned_pieces(const Position& pos, Color c) {
+    const Square ksq = pos.king_square(c);
+    return (c == WHITE) ? pinned_pieces<WHITE>(pos, ksq) : pinned_pieces<BLACK>(pos, ksq);
 }
 
 } // namespace chess
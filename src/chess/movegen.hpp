@@ -1,15 +1,28 @@
 #pragma once
 
-#include <vector>
 #include "position.hpp"
 #include "move.hpp"
+#include "movelist.hpp"
 #include "attacks.hpp"
 #include "legality.hpp"
 #include "make.hpp"
 
 namespace chess {
 
-void generate_pseudo_legal(const Position& pos, std::vector<Move>& out);
-void generate_legal(Position& pos, std::vector<Move>& out);
+void generate_pseudo_legal(const Position& pos, MoveList& out);
+void generate_legal(Position& pos, MoveList& out);
+
+// legal generation by stage; captures + quiets == generate_legal
+void generate_captures(const Position& pos, MoveList& out); // captures, EP and all promotions
+void generate_quiets(const Position& pos, MoveList& out);   // non-capture, non-promotion moves incl. castling
+void generate_evasions(const Position& pos, MoveList& out); // side to move must be in check
+
+// number of legal moves `side` would have in pos, from attack and pin masks alone
+// (no move list, no make/unmake). side may be either colour; EP only counts for stm
+int count_legal_moves(const Position& pos, Color side);
+
+// c's pieces that are the only blocker between c's king and an enemy slider
+// (the same pin mask the legal generator builds)
+Bitboard pinned_pieces(const Position& pos, Color c);
 
 } // namespace chess
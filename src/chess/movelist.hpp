@@ -0,0 +1,36 @@
+#pragma once
+
+#include "move.hpp"
+
+namespace chess {
+
+// fixed-capacity, stack-resident move buffer (no position has more than 218 legal moves).
+// scores[] is a parallel slot for move ordering; generators leave it untouched.
+struct MoveList {
+    static constexpr int CAPACITY = 256;
+
+    Move moves[CAPACITY];
+    int  scores[CAPACITY];
+    int  count = 0;
+
+    inline void push(Move m) { moves[count++] = m; }
+    inline void clear() { count = 0; }
+
+    inline int size() const { return count; }
+    inline bool empty() const { return count == 0; }
+
+    inline Move& operator[](int i) { return moves[i]; }
+    inline Move operator[](int i) const { return moves[i]; }
+
+    inline Move* begin() { return moves; }
+    inline Move* end() { return moves + count; }
+    inline const Move* begin() const { return moves; }
+    inline const Move* end() const { return moves + count; }
+
+    inline bool contains(Move m) const {
+        for (int i = 0; i < count; ++i) if (moves[i] == m) return true;
+        return false;
+    }
+};
+
+} // namespace chess
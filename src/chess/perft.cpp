@@ -0,0 +1,122 @@
+#include "perft.hpp"
+#include "movegen.hpp"
+#include "make.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <cassert>
+
+namespace chess {
+
+// shared leaf-count cache keyed by zobrist key + depth.
+// slots are written lock-free; check = key ^ nodes so a torn slot simply misses.
+class PerftHash {
+public:
+    explicit PerftHash(std::size_t mb) {
+        if (!mb) return;
+        std::size_t n = 1;
+        while (n * 2 * sizeof(Slot) <= mb * 1024ULL * 1024ULL) n *= 2;
+        slots_.reset(new Slot[n]);
+        mask_ = n - 1;
+    }
+
+    bool enabled() const { return slots_ != nullptr; }
+
+    bool probe(std::uint64_t key, int depth, std::uint64_t& nodes) const {
+        const std::uint64_t k = mix(key, depth);
+        const Slot& s = slots_[k & mask_];
+        const std::uint64_t n = s.nodes.load(std::memory_order_relaxed);
+        if ((s.check.load(std::memory_order_relaxed) ^ n) != k) return false;
+        nodes = n;
+        return true;
+    }
+
+    void store(std::uint64_t key, int depth, std::uint64_t nodes) {
+        const std::uint64_t k = mix(key, depth);
+        Slot& s = slots_[k & mask_];
+        s.check.store(k ^ nodes, std::memory_order_relaxed);
+        s.nodes.store(nodes, std::memory_order_relaxed);
+    }
+
+private:
+    struct Slot {
+        std::atomic<std::uint64_t> check{0};
+        std::atomic<std::uint64_t> nodes{0};
+    };
+
+    static std::uint64_t mix(std::uint64_t key, int depth) {
+        return key ^ (std::uint64_t(depth) * 0x9e3779b97f4a7c15ULL);
+    }
+
+    std::unique_ptr<Slot[]> slots_;
+    std::size_t mask_ = 0;
+};
+
+static std::uint64_t perft_rec(Position& pos, int depth, StateInfo* st, PerftHash& hash) {
+    MoveList moves;
+    if (depth == 1) {
+        generate_legal(pos, moves);
+        return moves.size();
+    }
+
+    std::uint64_t nodes = 0;
+    if (hash.enabled() && hash.probe(pos.key, depth, nodes)) return nodes;
+
+    generate_legal(pos, moves);
+    for (Move m : moves) {
+        do_move(pos, m, *st);
+        nodes += perft_rec(pos, depth - 1, st + 1, hash);
+        undo_move(pos, m, *st);
+    }
+
+    if (hash.enabled()) hash.store(pos.key, depth, nodes);
+    return nodes;
+}
+
+std::vector<PerftEntry> perft_divide(const Position& root, int depth, const PerftOptions& opt) {
+    assert(depth >= 1 && depth < MAX_PERFT_DEPTH);
+
+    Position pos = root;
+    MoveList moves;
+    generate_legal(pos, moves);
+
+    std::vector<PerftEntry> out(moves.size());
+    PerftHash hash(opt.hash_mb);
+    std::atomic<int> next{0};
+
+    // each worker owns a position copy and a state stack, and pulls root moves until none are left
+    auto worker = [&]() {
+        Position p = root;
+        StateInfo st[MAX_PERFT_DEPTH];
+        for (int i = next++; i < moves.size(); i = next++) {
+            const Move m = moves[i];
+            do_move(p, m, st[0]);
+            out[i].move = m;
+            out[i].nodes = (depth == 1) ? 1 : perft_rec(p, depth - 1, st + 1, hash);
+            undo_move(p, m, st[0]);
+        }
+    };
+
+    const int n = std::min(opt.threads, moves.size());
+    if (n <= 1) {
+        worker();
+    } else {
+        std::vector<std::thread> pool;
+        pool.reserve(n);
+        for (int i = 0; i < n; ++i) pool.emplace_back(worker);
+        for (std::thread& t : pool) t.join();
+    }
+    return out;
+}
+
+std::uint64_t perft(const Position& pos, int depth, const PerftOptions& opt) {
+    if (depth <= 0) return 1;
+
+    std::uint64_t total = 0;
+    for (const PerftEntry& e : perft_divide(pos, depth, opt)) total += e.nodes;
+    return total;
+}
+
+} // namespace chess
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+#include "position.hpp"
+#include "move.hpp"
+
+namespace chess {
+
+// depth must stay below this: each worker's StateInfo stack has one slot per ply
+constexpr int MAX_PERFT_DEPTH = 64;
+
+struct PerftOptions {
+    int threads = 1;         // root moves are split across this many workers
+    std::size_t hash_mb = 0; // perft cache size; 0 disables it
+};
+
+struct PerftEntry {
+    Move move;
+    std::uint64_t nodes;
+};
+
+// leaf count with bulk counting at depth 1 (no make/unmake on the last ply)
+std::uint64_t perft(const Position& pos, int depth, const PerftOptions& opt = {});
+
+// per-root-move leaf counts, in generation order
+std::vector<PerftEntry> perft_divide(const Position& pos, int depth, const PerftOptions& opt = {});
+
+} // namespace chess
@@ -1,99 +1,111 @@
 #include "position.hpp"
-#include <sstream>
-#include <cctype>
+#include "zobrist.hpp"
+#include "legality.hpp"
 
 namespace chess {
 
-static inline char piece_to_char(Color c, PieceType pt) {
-    char ch = '?';
-    switch (pt) {
-        case PAWN:   ch = 'p'; break;
-        case KNIGHT: ch = 'n'; break;
-        case BISHOP: ch = 'b'; break;
-        case ROOK:   ch = 'r'; break;
-        case QUEEN:  ch = 'q'; break;
-        case KING:   ch = 'k'; break;
-        default:     ch = '?'; break;
+// mailbox code -> FEN letter (NO_PIECE and the unused codes map to 0)
+static constexpr char PIECE_CHAR[16] = {
+    'P', 'N', 'B', 'R', 'Q', 'K', 0, 0,
+    'p', 'n', 'b', 'r', 'q', 'k', 0, 0
+};
+
+static inline Piece char_to_piece(char ch) {
+    switch (ch) {
+        case 'P': return W_PAWN;   case 'p': return B_PAWN;
+        case 'N': return W_KNIGHT; case 'n': return B_KNIGHT;
+        case 'B': return W_BISHOP; case 'b': return B_BISHOP;
+        case 'R': return W_ROOK;   case 'r': return B_ROOK;
+        case 'Q': return W_QUEEN;  case 'q': return B_QUEEN;
+        case 'K': return W_KING;   case 'k': return B_KING;
+        default:  return NO_PIECE;
     }
-    if (c == WHITE) ch = (char)std::toupper((unsigned char)ch);
-    return ch;
 }
 
-static inline bool char_to_piece(char ch, Color &c, PieceType &pt) {
-    if (ch >= 'A' && ch <= 'Z') c = WHITE;
-    else if (ch >= 'a' && ch <= 'z') c = BLACK;
-    else return false;
-
-    char lo = (char)std::tolower((unsigned char)ch);
-    switch (lo) {
-        case 'p': pt = PAWN;   return true;
-        case 'n': pt = KNIGHT; return true;
-        case 'b': pt = BISHOP; return true;
-        case 'r': pt = ROOK;   return true;
-        case 'q': pt = QUEEN;  return true;
-        case 'k': pt = KING;   return true;
-        default: return false;
+const char* fen_error_name(FenError e) {
+    switch (e) {
+        case FenError::OK:            return "ok";
+        case FenError::MISSING_FIELD: return "missing field";
+        case FenError::BAD_PLACEMENT: return "bad piece placement";
+        case FenError::BAD_SIDE:      return "bad side to move";
+        case FenError::BAD_CASTLING:  return "bad castling rights";
+        case FenError::BAD_EP:        return "bad en passant square";
+        case FenError::BAD_CLOCKS:    return "bad move clocks";
+        case FenError::BAD_KINGS:     return "need exactly one king per side";
     }
+    return "unknown";
 }
 
-bool Position::set_fen(const std::string& fen) {
-    clear();
-
-    std::istringstream iss(fen);
-    std::string board, side, castle, ep;
-    int half = 0, full = 1;
+// next space-separated field of s starting at pos (empty at end of input)
+static inline std::string_view next_field(std::string_view s, std::size_t& pos) {
+    while (pos < s.size() && (s[pos] == ' ' || s[pos] == '\t')) ++pos;
+    const std::size_t start = pos;
+    while (pos < s.size() && s[pos] != ' ' && s[pos] != '\t' && s[pos] != '\r' && s[pos] != '\n') ++pos;
+    return s.substr(start, pos - start);
+}
 
-    if (!(iss >> board >> side >> castle >> ep)) return false;
-    // half/full are optional in some inputs
-    if (iss >> half >> full) {
-        halfmove_clock = half;
-        fullmove_number = full;
-    } else {
-        halfmove_clock = 0;
-        fullmove_number = 1;
+// optional clock field; empty or non-numeric leaves `out` alone and reports false
+static inline bool parse_clock(std::string_view field, uint16_t& out, bool& bad) {
+    if (field.empty() || field[0] < '0' || field[0] > '9') return false;
+    unsigned v = 0;
+    for (char ch : field) {
+        if (ch < '0' || ch > '9' || v > 6553) { bad = true; return false; }
+        v = v * 10 + unsigned(ch - '0');
     }
+    if (v > 0xFFFF) { bad = true; return false; }
+    out = uint16_t(v);
+    return true;
+}
 
-    // 1) board
+FenError Position::parse_fen(std::string_view fen) {
+    clear();
+
+    std::size_t pos = 0;
+    const std::string_view placement = next_field(fen, pos);
+    const std::string_view side = next_field(fen, pos);
+    const std::string_view castle = next_field(fen, pos);
+    const std::string_view ep = next_field(fen, pos);
+    if (ep.empty()) return FenError::MISSING_FIELD;
+
+    // 1) board: eight ranks of exactly eight files, rank 8 first
     int r = 7;
     int f = 0;
-
-    for (char ch : board) {
+    for (char ch : placement) {
         if (ch == '/') {
+            if (f != 8 || r == 0) return FenError::BAD_PLACEMENT;
             r--;
             f = 0;
-            if (r < 0) return false;
-            continue;
-        }
-
-        if (std::isdigit((unsigned char)ch)) {
+        } else if (ch >= '1' && ch <= '8') {
             f += ch - '0';
-            if (f > 8) return false;
-            continue;
+            if (f > 8) return FenError::BAD_PLACEMENT;
+        } else {
+            const Piece p = char_to_piece(ch);
+            if (p == NO_PIECE || f > 7) return FenError::BAD_PLACEMENT;
+            const Square sq = mk_sq(f, r);
+            pieces[color_of(p)][type_of(p)] |= bb_of(sq);
+            board[sq] = p;
+            f++;
         }
-
-        Color c;
-        PieceType pt;
-        if (!char_to_piece(ch, c, pt)) return false;
-
-        if (f < 0 || f > 7 || r < 0 || r > 7) return false;
-        Square sq = mk_sq(f, r);
-        pieces[c][pt] |= bb_of(sq);
-        f++;
     }
-
-    if (r != 0) {
-        // if we didn't end on rank 1 after parsing, it's malformed
-        // (some malformed FENs might still pass; we’ll be strict)
-        // But allow exact finish at r==0 and f==8.
+    if (r != 0 || f != 8) return FenError::BAD_PLACEMENT;
+
+    // counts a game can reach; they also keep material_key's per-count slots (16 per
+    // piece kind) in range once the remaining pawns promote
+    for (int c = 0; c < 2; ++c) {
+        const int pawns = popcount(pieces[c][PAWN]);
+        if (pawns > 8) return FenError::BAD_PLACEMENT;
+        for (int pt = KNIGHT; pt <= QUEEN; ++pt) {
+            const int n = popcount(pieces[c][pt]);
+            if (n > 10 || n + pawns > 16) return FenError::BAD_PLACEMENT;
+        }
     }
 
     // 2) side to move
     if (side == "w") stm = WHITE;
     else if (side == "b") stm = BLACK;
-    else return false;
+    else return FenError::BAD_SIDE;
 
     // 3) castling
-    castling_rights = 0;
     if (castle != "-") {
         for (char cch : castle) {
             switch (cch) {
@@ -101,100 +113,127 @@ bool Position::set_fen(const std::string& fen) {
                 case 'Q': castling_rights |= uint8_t(WHITE_QUEEN_SIDE); break;
                 case 'k': castling_rights |= uint8_t(BLACK_KING_SIDE);  break;
                 case 'q': castling_rights |= uint8_t(BLACK_QUEEN_SIDE); break;
-                default: return false;
+                default: return FenError::BAD_CASTLING;
             }
         }
     }
 
+    // a right is only kept while its king and rook are still on their starting squares
+    struct CastleHome { uint8_t right; Color c; Square rook; };
+    static constexpr CastleHome HOMES[4] = {
+        {uint8_t(WHITE_KING_SIDE),  WHITE, mk_sq(7, 0)}, {uint8_t(WHITE_QUEEN_SIDE), WHITE, mk_sq(0, 0)},
+        {uint8_t(BLACK_KING_SIDE),  BLACK, mk_sq(7, 7)}, {uint8_t(BLACK_QUEEN_SIDE), BLACK, mk_sq(0, 7)},
+    };
+    for (const CastleHome& h : HOMES) {
+        if (!(castling_rights & h.right)) continue;
+        const Square ksq = mk_sq(4, h.c == WHITE ? 0 : 7);
+        if (board[ksq] != make_piece(h.c, KING) || board[h.rook] != make_piece(h.c, ROOK)) {
+            return FenError::BAD_CASTLING;
+        }
+    }
+
     // 4) en passant
-    en_passant_square = NO_SQUARE;
     if (ep != "-") {
-        if (ep.size() != 2) return false;
-        char file = ep[0];
-        char rank = ep[1];
-        if (file < 'a' || file > 'h') return false;
-        if (rank < '1' || rank > '8') return false;
-        int ff = file - 'a';
-        int rr = rank - '1';
-        en_passant_square = mk_sq(ff, rr);
+        if (ep.size() != 2) return FenError::BAD_EP;
+        if (ep[0] < 'a' || ep[0] > 'h') return FenError::BAD_EP;
+        if (ep[1] != (stm == WHITE ? '6' : '3')) return FenError::BAD_EP; // behind a pawn that just double-pushed
+        en_passant_square = mk_sq(ep[0] - 'a', ep[1] - '1');
+
+        // the pawn that just double-pushed stands in front of the square; it and the
+        // pawn's start square are empty
+        const Square t = en_passant_square;
+        const int d = (stm == WHITE) ? 8 : -8;
+        if (board[t - d] != make_piece(~stm, PAWN) || board[t] != NO_PIECE || board[t + d] != NO_PIECE) {
+            return FenError::BAD_EP;
+        }
+    }
+
+    // 5) clocks are optional in some inputs (EPD); both default when either is missing
+    bool bad = false;
+    uint16_t half = 0, full = 1;
+    if (parse_clock(next_field(fen, pos), half, bad) && parse_clock(next_field(fen, pos), full, bad)) {
+        halfmove_clock = half;
+        fullmove_number = full;
     }
+    if (bad) return FenError::BAD_CLOCKS;
 
     update_occ();
 
     // sanity: exactly one king each
-    if (popcount(pieces[WHITE][KING]) != 1) return false;
-    if (popcount(pieces[BLACK][KING]) != 1) return false;
+    if (popcount(pieces[WHITE][KING]) != 1) return FenError::BAD_KINGS;
+    if (popcount(pieces[BLACK][KING]) != 1) return FenError::BAD_KINGS;
+
+    key = compute_key(*this);
+    pawn_key = compute_pawn_key(*this);
+    material_key = compute_material_key(*this);
+    checkers = attackers_to(*this, king_square(stm), occ[OCC_BOTH]) & occ[~stm];
+    return FenError::OK;
+}
 
-    return true;
+static inline char* write_uint(char* p, unsigned v) {
+    char tmp[10];
+    int n = 0;
+    do { tmp[n++] = char('0' + v % 10); v /= 10; } while (v);
+    while (n) *p++ = tmp[--n];
+    return p;
 }
 
-std::string Position::fen() const {
-    // 1) board
-    std::string out;
-    out.reserve(100);
+std::size_t Position::write_fen(char* buf) const {
+    char* p = buf;
 
+    // 1) board
     for (int r = 7; r >= 0; --r) {
         int emptyCount = 0;
         for (int f = 0; f < 8; ++f) {
-            Square sq = mk_sq(f, r);
-            Bitboard m = bb_of(sq);
-
-            char ch = 0;
-            for (int c = 0; c < 2 && !ch; ++c) {
-                for (int p = 0; p < 6; ++p) {
-                    if (pieces[c][p] & m) {
-                        ch = piece_to_char((Color)c, (PieceType)p);
-                        break;
-                    }
-                }
-            }
-
+            const char ch = PIECE_CHAR[board[mk_sq(f, r)]];
             if (!ch) {
                 emptyCount++;
-            } else {
-                if (emptyCount) {
-                    out.push_back(char('0' + emptyCount));
-                    emptyCount = 0;
-                }
-                out.push_back(ch);
+                continue;
             }
+            if (emptyCount) {
+                *p++ = char('0' + emptyCount);
+                emptyCount = 0;
+            }
+            *p++ = ch;
         }
-        if (emptyCount) out.push_back(char('0' + emptyCount));
-        if (r) out.push_back('/');
+        if (emptyCount) *p++ = char('0' + emptyCount);
+        if (r) *p++ = '/';
     }
 
     // 2) stm
-    out.push_back(' ');
-    out.push_back(stm == WHITE ? 'w' : 'b');
+    *p++ = ' ';
+    *p++ = (stm == WHITE) ? 'w' : 'b';
 
     // 3) castling
-    out.push_back(' ');
-    std::string cast;
-    if (castling_rights & WHITE_KING_SIDE)  cast.push_back('K');
-    if (castling_rights & WHITE_QUEEN_SIDE) cast.push_back('Q');
-    if (castling_rights & BLACK_KING_SIDE)  cast.push_back('k');
-    if (castling_rights & BLACK_QUEEN_SIDE) cast.push_back('q');
-    if (cast.empty()) cast = "-";
-    out += cast;
+    *p++ = ' ';
+    if (!castling_rights) *p++ = '-';
+    if (castling_rights & WHITE_KING_SIDE)  *p++ = 'K';
+    if (castling_rights & WHITE_QUEEN_SIDE) *p++ = 'Q';
+    if (castling_rights & BLACK_KING_SIDE)  *p++ = 'k';
+    if (castling_rights & BLACK_QUEEN_SIDE) *p++ = 'q';
 
     // 4) ep
-    out.push_back(' ');
+    *p++ = ' ';
     if (en_passant_square == NO_SQUARE) {
-        out.push_back('-');
+        *p++ = '-';
     } else {
-        int ff = f_of(en_passant_square);
-        int rr = r_of(en_passant_square);
-        out.push_back(char('a' + ff));
-        out.push_back(char('1' + rr));
+        *p++ = char('a' + f_of(en_passant_square));
+        *p++ = char('1' + r_of(en_passant_square));
     }
 
     // 5) clocks
-    out.push_back(' ');
-    out += std::to_string(halfmove_clock);
-    out.push_back(' ');
-    out += std::to_string(fullmove_number);
+    *p++ = ' ';
+    p = write_uint(p, halfmove_clock);
+    *p++ = ' ';
+    p = write_uint(p, fullmove_number);
+
+    *p = '\0';
+    return std::size_t(p - buf);
+}
 
-    return out;
+std::string Position::fen() const {
+    char buf[FEN_MAX];
+    return std::string(buf, write_fen(buf));
 }
 
 } // namespace chess
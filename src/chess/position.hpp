@@ -1,6 +1,9 @@
 #pragma once
 
 #include <string>
+#include <string_view>
+#include <cstddef>
+#include <cstdint>
 #include "types.hpp"
 #include "bitboard.hpp"
 
@@ -8,23 +11,53 @@ namespace chess {
 
 enum OccIndex : int { OCC_WHITE = 0, OCC_BLACK = 1, OCC_BOTH = 2 };
 
-struct Position {
+enum class FenError : uint8_t {
+    OK = 0,
+    MISSING_FIELD,
+    BAD_PLACEMENT,
+    BAD_SIDE,
+    BAD_CASTLING,
+    BAD_EP,
+    BAD_CLOCKS,
+    BAD_KINGS
+};
+
+const char* fen_error_name(FenError e);
+
+// longest FEN write_fen can produce, terminating NUL included
+constexpr std::size_t FEN_MAX = 128;
+
+// one copy is four cache lines; copy-make (do_move_copy) relies on that staying small
+struct alignas(64) Position {
     // pieces[color][pieceType] where pieceType is PAWN..KING (0..5)
     Bitboard pieces[2][6]{};
 
     // occupancies
     Bitboard occ[3]{}; // [white, black, both]
 
+    // zobrist key; set by set_fen, maintained incrementally by do_move/undo_move
+    std::uint64_t key = 0;
+    std::uint64_t pawn_key = 0;     // same, over pawns only (pawn hash index)
+    std::uint64_t material_key = 0; // same, over piece counts per colour and type (material hash index)
+
+    // enemy pieces giving check to stm; set by set_fen, cached by do_move
+    Bitboard checkers = 0ULL;
+
+    // mailbox mirror of pieces[][], NO_PIECE on empty squares
+    Piece board[64];
+
     Color stm = WHITE;
     uint8_t castling_rights = 0; // bitmask using Castling bits
     Square en_passant_square = NO_SQUARE;
 
     // optional bookkeeping (useful for perft/fen/50-move later)
-    int halfmove_clock = 0;
-    int fullmove_number = 1;
+    uint16_t halfmove_clock = 0;
+    uint16_t fullmove_number = 1;
 
     // ---------------- core maintenance ----------------
 
+    Position() { clear(); }
+
     inline void clear() {
         for (int c = 0; c < 2; ++c)
             for (int p = 0; p < 6; ++p)
@@ -32,11 +65,17 @@ struct Position {
 
         occ[OCC_WHITE] = occ[OCC_BLACK] = occ[OCC_BOTH] = 0ULL;
 
+        for (int sq = 0; sq < 64; ++sq) board[sq] = NO_PIECE;
+
         stm = WHITE;
         castling_rights = 0;
         en_passant_square = NO_SQUARE;
         halfmove_clock = 0;
         fullmove_number = 1;
+        key = 0;
+        pawn_key = 0;
+        material_key = 0;
+        checkers = 0ULL;
     }
 
     inline void update_occ() {
@@ -66,26 +105,13 @@ struct Position {
 
     // returns NO_PIECE_TYPE if empty. sets outColor if found.
     inline PieceType piece_on(Square sq, Color &outColor) const {
-        Bitboard m = bb_of(sq);
-
-        // quick reject
-        if ((occ[OCC_BOTH] & m) == 0ULL) {
-            outColor = WHITE; // arbitrary
-            return NO_PIECE_TYPE;
-        }
-
-        for (int c = 0; c < 2; ++c) {
-            if ((occ[c] & m) == 0ULL) continue;
-            for (int p = 0; p < 6; ++p) {
-                if (pieces[c][p] & m) {
-                    outColor = (Color)c;
-                    return (PieceType)p;
-                }
-            }
-        }
+        Piece p = board[sq];
+        outColor = (p == NO_PIECE) ? WHITE : color_of(p); // arbitrary when empty
+        return type_of(p);
+    }
 
-        outColor = WHITE; // arbitrary
-        return NO_PIECE_TYPE;
+    inline PieceType piece_type_on(Square sq) const {
+        return type_of(board[sq]);
     }
 
     inline Square king_square(Color c) const {
@@ -99,9 +125,15 @@ struct Position {
     inline bool can_castle(Castling cr) const { return (castling_rights & cr) != 0; }
     inline void disable_castle(Castling cr) { castling_rights &= ~uint8_t(cr); }
 
-    // ---------------- FEN (optional stubs) ----------------
-    
-    bool set_fen(const std::string& fen);
+    // ---------------- FEN ----------------
+
+    // no allocations; anything after the clocks (e.g. EPD opcodes) is ignored.
+    // the position is unspecified unless OK is returned.
+    FenError parse_fen(std::string_view fen);
+    inline bool set_fen(std::string_view fen) { return parse_fen(fen) == FenError::OK; }
+
+    // single pass over the mailbox into buf (at least FEN_MAX bytes); returns the length
+    std::size_t write_fen(char* buf) const;
     std::string fen() const;
 };
 
@@ -0,0 +1,56 @@
+#include "repetition.hpp"
+#include "movegen.hpp"
+
+#include <algorithm>
+
+namespace chess {
+
+bool is_repetition(const Position& pos, const KeyHistory& hist, int ply) {
+    // captures and pawn moves reset halfmove_clock and cannot be undone, so nothing
+    // older than that can match; same side to move means even steps only
+    const int end = std::min<int>(pos.halfmove_clock, hist.size());
+
+    int seen = 0;
+    for (int i = 4; i <= end; i += 2) {
+        if (hist.ago(i) != pos.key) continue;
+        if (i < ply || ++seen == 2) return true;
+    }
+    return false;
+}
+
+bool is_fifty_move_draw(const Position& pos) {
+    if (pos.halfmove_clock < 100) return false;
+    if (!pos.checkers) return true;
+
+    MoveList moves;
+    generate_evasions(pos, moves);
+    return !moves.empty();
+}
+
+bool has_upcoming_repetition(const Position& pos, const KeyHistory& hist, int ply) {
+    const int end = std::min<int>(pos.halfmove_clock, hist.size());
+    if (end < 3) return false;
+
+    const Bitboard occ = pos.occ[OCC_BOTH];
+
+    // odd steps: the earlier position has the other side to move, so the key difference
+    // is one piece move plus the side key, which is exactly what the table holds
+    for (int i = 3; i <= end; i += 2) {
+        const std::uint64_t move_key = pos.key ^ hist.ago(i);
+
+        int j = detail::cuckoo_h1(move_key);
+        if (detail::CUCKOO.key[j] != move_key) {
+            j = detail::cuckoo_h2(move_key);
+            if (detail::CUCKOO.key[j] != move_key) continue;
+        }
+
+        const Move m = detail::CUCKOO.move[j];
+        if (between_bb[from(m)][to(m)] & occ) continue;
+
+        // only cycles closing inside the search; game-history ones need a real threefold
+        if (ply > i) return true;
+    }
+    return false;
+}
+
+} // namespace chess
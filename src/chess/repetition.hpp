@@ -0,0 +1,97 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "position.hpp"
+#include "move.hpp"
+#include "attacks.hpp"
+#include "zobrist.hpp"
+
+namespace chess {
+
+// Zobrist keys of the positions that led to the current one, oldest first:
+// game history from the GUI, then the search path on top of it
+struct KeyHistory {
+    std::vector<std::uint64_t> keys;
+
+    inline void clear() { keys.clear(); }
+    inline void push(std::uint64_t k) { keys.push_back(k); }
+    inline void pop() { keys.pop_back(); }
+    inline int size() const { return int(keys.size()); }
+
+    // key of the position i plies before the current one (1 <= i <= size())
+    inline std::uint64_t ago(int i) const { return keys[keys.size() - std::size_t(i)]; }
+};
+
+// the current position repeats one inside the reversible window (halfmove_clock).
+// a repeat of a position inside the search (fewer than `ply` back) is a draw on its
+// own; a repeat of the root or of game history only counts as a third occurrence
+bool is_repetition(const Position& pos, const KeyHistory& hist, int ply);
+
+// fifty-move rule; a mate delivered on the 100th half-move still counts as mate
+bool is_fifty_move_draw(const Position& pos);
+
+// side to move has a reversible move that reaches a position already on the
+// search path (Marcel van Kervinck's cuckoo test). lets the search claim the
+// draw score one ply before the repetition is actually played
+bool has_upcoming_repetition(const Position& pos, const KeyHistory& hist, int ply);
+
+namespace detail {
+
+// one entry per reversible non-pawn move (piece, a <-> b): key of the move, and the move
+struct CuckooTables {
+    std::uint64_t key[8192];
+    Move move[8192];
+};
+
+constexpr int cuckoo_h1(std::uint64_t k) { return int(k & 0x1FFF); }
+constexpr int cuckoo_h2(std::uint64_t k) { return int((k >> 16) & 0x1FFF); }
+
+constexpr Bitboard empty_board_attacks(PieceType pt, Square sq) {
+    switch (pt) {
+        case KNIGHT: return LEAPERS.knight[sq];
+        case BISHOP: return bishop_attacks_ray(sq, 0ULL);
+        case ROOK:   return rook_attacks_ray(sq, 0ULL);
+        case QUEEN:  return bishop_attacks_ray(sq, 0ULL) | rook_attacks_ray(sq, 0ULL);
+        case KING:   return LEAPERS.king[sq];
+        default:     return 0ULL;
+    }
+}
+
+constexpr CuckooTables make_cuckoo_tables() {
+    CuckooTables t{};
+    for (int c = 0; c < 2; ++c) {
+        for (int pt = KNIGHT; pt <= KING; ++pt) {
+            for (int a = 0; a < 64; ++a) {
+                for (int b = a + 1; b < 64; ++b) {
+                    if (!(empty_board_attacks(PieceType(pt), a) & bb_of(b))) continue;
+
+                    std::uint64_t k = ZB.piece[c][pt][a] ^ ZB.piece[c][pt][b] ^ ZB.side;
+                    Move m = make_move(Square(a), Square(b));
+
+                    // cuckoo insert: evict the occupant to its other slot until one is free
+                    int i = cuckoo_h1(k);
+                    while (true) {
+                        const std::uint64_t tk = t.key[i];
+                        const Move tm = t.move[i];
+                        t.key[i] = k;
+                        t.move[i] = m;
+                        if (tm == NO_MOVE) break;
+                        k = tk;
+                        m = tm;
+                        i = (i == cuckoo_h1(k)) ? cuckoo_h2(k) : cuckoo_h1(k);
+                    }
+                }
+            }
+        }
+    }
+    return t;
+}
+
+inline constexpr CuckooTables CUCKOO = make_cuckoo_tables();
+
+} // namespace detail
+
+} // namespace chess
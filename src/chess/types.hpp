@@ -11,10 +11,21 @@ constexpr Square NO_SQUARE = -1;
 enum Color : uint8_t
 {WHITE = 0, BLACK = 1}; 
 
-inline Color operator~(Color c) { return Color(c ^ 1); }
+constexpr Color operator~(Color c) { return Color(c ^ 1); }
 
 enum PieceType {PAWN, KNIGHT, BISHOP, ROOK, QUEEN, KING, NO_PIECE_TYPE};
 
+// mailbox code: (color << 3) | type, so type_of(NO_PIECE) == NO_PIECE_TYPE
+enum Piece : uint8_t {
+    W_PAWN = 0, W_KNIGHT, W_BISHOP, W_ROOK, W_QUEEN, W_KING,
+    NO_PIECE = 6,
+    B_PAWN = 8, B_KNIGHT, B_BISHOP, B_ROOK, B_QUEEN, B_KING
+};
+
+constexpr Piece make_piece(Color c, PieceType pt) { return Piece((int(c) << 3) | int(pt)); }
+constexpr PieceType type_of(Piece p) { return PieceType(p & 7); }
+constexpr Color color_of(Piece p) { return Color(p >> 3); }
+
 enum Castling : uint8_t {
     WHITE_KING_SIDE  = 1 << 0,
     WHITE_QUEEN_SIDE = 1 << 1,
@@ -36,4 +47,13 @@ constexpr Bitboard FILE_E = FILE_A << 4;
 constexpr Bitboard FILE_F = FILE_A << 5;
 constexpr Bitboard FILE_G = FILE_A << 6;
 constexpr Bitboard FILE_H = FILE_A << 7;
+
+constexpr Bitboard RANK_1 = 0x00000000000000FFULL;
+constexpr Bitboard RANK_2 = RANK_1 << 8;
+constexpr Bitboard RANK_3 = RANK_1 << 16;
+constexpr Bitboard RANK_4 = RANK_1 << 24;
+constexpr Bitboard RANK_5 = RANK_1 << 32;
+constexpr Bitboard RANK_6 = RANK_1 << 40;
+constexpr Bitboard RANK_7 = RANK_1 << 48;
+constexpr Bitboard RANK_8 = RANK_1 << 56;
 } // namespace chess
\ No newline at end of file
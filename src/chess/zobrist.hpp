@@ -5,17 +5,44 @@
 
 namespace chess {
 
+constexpr std::uint64_t splitmix64(std::uint64_t& x) {
+    std::uint64_t z = (x += 0x9e3779b97f4a7c15ULL);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
 struct Zobrist {
     std::uint64_t piece[2][6][64]{};
     std::uint64_t castling[16]{};
     std::uint64_t ep_file[9]{};
     std::uint64_t side{};
+    std::uint64_t material[2][6][16]{}; // [c][pt][i]: the (i+1)-th piece of that kind
+
+    static constexpr Zobrist make(std::uint64_t seed = 0x9e3779b97f4a7c15ULL) {
+        Zobrist z{};
+        std::uint64_t x = seed;
+        for (int c = 0; c < 2; ++c)
+            for (int p = 0; p < 6; ++p)
+                for (int s = 0; s < 64; ++s)
+                    z.piece[c][p][s] = splitmix64(x);
 
-    void init(std::uint64_t seed = 0x9e3779b97f4a7c15ULL);
+        for (int i = 0; i < 16; ++i) z.castling[i] = splitmix64(x);
+        for (int i = 0; i < 9;  ++i) z.ep_file[i] = splitmix64(x);
+        z.side = splitmix64(x);
+        for (int c = 0; c < 2; ++c)
+            for (int p = 0; p < 6; ++p)
+                for (int i = 0; i < 16; ++i)
+                    z.material[c][p][i] = splitmix64(x);
+        return z;
+    }
 };
 
-extern Zobrist ZB;
+// compile-time keys: no boot order to get wrong, and every key is valid before main()
+inline constexpr Zobrist ZB = Zobrist::make();
 
 std::uint64_t compute_key(const Position& pos);
+std::uint64_t compute_pawn_key(const Position& pos);
+std::uint64_t compute_material_key(const Position& pos);
 
 } // namespace chess
@@ -1,5 +1,7 @@
 #include "comp_material.hpp"
 
+#include <cassert>
+
 namespace eval {
 
 int CompMaterial::piece_value(chess::PieceType pt) {
@@ -13,59 +15,31 @@ int CompMaterial::piece_value(chess::PieceType pt) {
     }
 }
 
-chess::PieceType CompMaterial::captured_piece_type_at(
-    const chess::Position& pos,
-    chess::Color victim,
-    chess::Square sq
-) {
-    const chess::Bitboard m = chess::bb_of(sq);
-    for (int p = 0; p < 6; ++p) {
-        if (pos.pieces[(int)victim][p] & m) return (chess::PieceType)p;
-    }
-    return chess::NO_PIECE_TYPE;
-}
-
-PhaseScore CompMaterial::value(const chess::Position& pos, chess::Color us) const {
-    const chess::Color them = ~us;
-
-    int usMat = 0;
-    int themMat = 0;
-
-    // PAWN..QUEEN only; kings ignored
-    for (int p = chess::PAWN; p <= chess::QUEEN; ++p) {
-        const auto pt = (chess::PieceType)p;
-        const int v = piece_value(pt);
-
-        usMat   += v * chess::popcount(pos.pieces[(int)us][p]);
-        themMat += v * chess::popcount(pos.pieces[(int)them][p]);
-    }
-
-    const int s = usMat - themMat;
-    return {s, s};
+PhaseScore CompMaterial::value(const chess::Position& pos, chess::Color us, const EvalContext&) const {
+    // balance is kept incrementally; only the count-based imbalance needs the table
+    const MaterialEntry& e = entry(pos);
+    assert(acc_.diff(chess::WHITE) == e.balance && acc_.matches(pos));
+    const PhaseScore imb = (us == chess::WHITE) ? e.imbalance : -e.imbalance;
+    return acc_.diff(us) + imb;
 }
 
-MoveDelta CompMaterial::estimate_delta(const chess::Position& pos, chess::Move m) const {
+MoveDelta CompMaterial::estimate_delta(const chess::Position& pos, chess::Move m, const chess::CheckInfo&) const {
     MoveDelta out{};
 
     const chess::Square f = chess::from(m);
     const chess::Square t = chess::to(m);
     const uint32_t fl = chess::flags(m);
 
-    const chess::Color us = pos.stm;
-    const chess::Color them = ~us;
-
     // captures
     if (fl & chess::EP) {
         // en-passant is always capturing a pawn
-        out.delta.mg += P;
-        out.delta.eg += P;
+        out.delta += PhaseScore{P, P};
         out.valid = true;
     } else if (fl & chess::CAPTURE_MOVE) {
-        const chess::PieceType cpt = captured_piece_type_at(pos, them, t);
+        const chess::PieceType cpt = pos.piece_type_on(t);
         const int v = piece_value(cpt);
         if (v != 0) {
-            out.delta.mg += v;
-            out.delta.eg += v;
+            out.delta += PhaseScore{v, v};
             out.valid = true;
         }
     }
@@ -76,8 +50,7 @@ MoveDelta CompMaterial::estimate_delta(const chess::Position& pos, chess::Move m
         const auto newpt = (chess::PieceType)chess::promo(m);
         const int v = piece_value(newpt) - P;
         if (v != 0) {
-            out.delta.mg += v;
-            out.delta.eg += v;
+            out.delta += PhaseScore{v, v};
             out.valid = true;
         }
     }
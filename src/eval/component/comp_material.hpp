@@ -1,6 +1,8 @@
 #pragma once
 
 #include "../eval_component.hpp"
+#include "../material_hash.hpp"
+#include "../eval_accumulator.hpp"
 
 // chess headers (component/ is nested under eval/)
 #include "../../chess/position.hpp"
@@ -10,16 +12,30 @@
 namespace eval {
 
 struct CompMaterial {
-    void init(const chess::Position&) {}
+    void init(const chess::Position& pos) { acc_.init(pos); }
 
-    PhaseScore value(const chess::Position& pos, chess::Color us) const;
+    PhaseScore value(const chess::Position& pos, chess::Color us, const EvalContext& ctx) const;
 
-    void on_make_move(const chess::Position&, chess::Move) {}
-    void on_unmake_move(const chess::Position&, chess::Move) {}
+    void on_make_move(const chess::Position& pos, chess::Move m) { acc_.push(pos, m); }
+    void on_unmake_move(const chess::Position&, chess::Move) { acc_.pop(); }
 
-    MoveDelta estimate_delta(const chess::Position& pos, chess::Move m) const;
+    MoveDelta estimate_delta(const chess::Position& pos, chess::Move m, const chess::CheckInfo&) const;
+
+    // phase, balance, imbalance and scale for pos's piece counts, in one probe of the
+    // attached table (or computed from scratch without one)
+    const MaterialEntry& entry(const chess::Position& pos) const {
+        if (table_) return table_->probe(pos);
+        MaterialTable::evaluate(pos, scratch_);
+        return scratch_;
+    }
+
+    // the table belongs to the caller and outlives this component; nullptr = no caching
+    void attach_table(MaterialTable* t) { table_ = t; }
 
 private:
+    MaterialTable* table_ = nullptr;  // a cache: value() stays logically const
+    mutable MaterialEntry scratch_{}; // result when no table is attached
+
     static constexpr int P = 100;
     static constexpr int N = 320;
     static constexpr int B = 330;
@@ -28,11 +44,12 @@ private:
 
     static int piece_value(chess::PieceType pt);
 
-    static chess::PieceType captured_piece_type_at(
-        const chess::Position& pos,
-        chess::Color victim,
-        chess::Square sq
-    );
+    static PhaseScore material(chess::PieceType pt, chess::Square, chess::Color) {
+        const int v = piece_value(pt);
+        return {v, v};
+    }
+
+    Accumulator<&CompMaterial::material> acc_{}; // running piece values per colour
 };
 
 } // namespace eval
\ No newline at end of file
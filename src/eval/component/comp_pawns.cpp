@@ -0,0 +1,10 @@
+#include "comp_pawns.hpp"
+
+namespace eval {
+
+PhaseScore CompPawns::value(const chess::Position& pos, chess::Color us, const EvalContext&) const {
+    const PhaseScore s = entry(pos).score;
+    return (us == chess::WHITE) ? s : -s;
+}
+
+} // namespace eval
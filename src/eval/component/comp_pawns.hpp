@@ -0,0 +1,36 @@
+#pragma once
+
+#include "../eval_component.hpp"
+#include "../pawn_hash.hpp"
+#include "../../chess/position.hpp"
+#include "../../chess/move.hpp"
+
+namespace eval {
+
+// pawn structure, served from the attached pawn hash (the table fills itself on a miss);
+// without one every call evaluates from scratch
+struct CompPawns {
+    void init(const chess::Position&) {}
+
+    PhaseScore value(const chess::Position& pos, chess::Color us, const EvalContext& ctx) const;
+
+    void on_make_move(const chess::Position&, chess::Move) {}
+    void on_unmake_move(const chess::Position&, chess::Move) {}
+
+    MoveDelta estimate_delta(const chess::Position&, chess::Move, const chess::CheckInfo&) const { return {}; }
+
+    const PawnEntry& entry(const chess::Position& pos) const {
+        if (table_) return table_->probe(pos);
+        PawnTable::evaluate(pos, scratch_);
+        return scratch_;
+    }
+
+    // the table belongs to the caller and outlives this component; nullptr = no caching
+    void attach_table(PawnTable* t) { table_ = t; }
+
+private:
+    PawnTable* table_ = nullptr;   // a cache: value() stays logically const
+    mutable PawnEntry scratch_{};  // result when no table is attached
+};
+
+} // namespace eval
@@ -4,32 +4,21 @@
 #include "../../chess/position.hpp"
 #include "../../chess/move.hpp"
 #include "../../chess/movegen.hpp"
-#include "../../chess/make.hpp"
 #include "../../chess/legality.hpp"
 
-#include <vector>
-
 namespace eval {
 
 // “suffocation” / restriction: primarily opponent legal move count.
-// safe fallback: recompute counts on every make/unmake (fast enough for now; optimize later).
+// counted lazily in value() from attack/pin masks, so make/unmake pay nothing.
 struct CompProphylaxis {
-    void init(const chess::Position& pos) { recompute(pos); }
-
-    PhaseScore value(const chess::Position& pos, chess::Color us) const;
-
-    void on_make_move(const chess::Position& pos, chess::Move) { recompute(pos); }
-    void on_unmake_move(const chess::Position& pos, chess::Move) { recompute(pos); }
-
-    MoveDelta estimate_delta(const chess::Position& pos, chess::Move m) const;
+    void init(const chess::Position&) {}
 
-private:
-    // cached legal move counts by side in the *current* position
-    int legal_ct[2]{0,0};
+    PhaseScore value(const chess::Position& pos, chess::Color us, const EvalContext& ctx) const;
 
-    void recompute(const chess::Position& pos);
+    void on_make_move(const chess::Position&, chess::Move) {}
+    void on_unmake_move(const chess::Position&, chess::Move) {}
 
-    static int legal_moves_for_side(const chess::Position& pos, chess::Color side);
+    MoveDelta estimate_delta(const chess::Position& pos, chess::Move m, const chess::CheckInfo& ci) const;
 };
 
 } // namespace eval
\ No newline at end of file
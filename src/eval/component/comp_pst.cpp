@@ -1,29 +1,16 @@
 #include "comp_pst.hpp"
 
-namespace eval {
-
-PhaseScore CompPST::value(const chess::Position& pos, chess::Color us) const {
-    const chess::Color them = ~us;
-
-    PhaseScore usS{}, themS{};
+#include <cassert>
 
-    for (int pt = 0; pt < 6; ++pt) { // includes king
-        chess::Bitboard b = pos.pieces[(int)us][pt];
-        while (b) {
-            chess::Square sq = chess::pop_lsb(b);
-            usS += pst((chess::PieceType)pt, sq, us);
-        }
-        b = pos.pieces[(int)them][pt];
-        while (b) {
-            chess::Square sq = chess::pop_lsb(b);
-            themS += pst((chess::PieceType)pt, sq, them);
-        }
-    }
+namespace eval {
 
-    return usS - themS;
+PhaseScore CompPST::value(const chess::Position& pos, chess::Color us, const EvalContext&) const {
+    assert(acc_.matches(pos));
+    (void)pos;
+    return acc_.diff(us);
 }
 
-MoveDelta CompPST::estimate_delta(const chess::Position& pos, chess::Move m) const {
+MoveDelta CompPST::estimate_delta(const chess::Position& pos, chess::Move m, const chess::CheckInfo&) const {
     MoveDelta out{};
 
     const chess::Color us = pos.stm;
@@ -33,7 +20,7 @@ MoveDelta CompPST::estimate_delta(const chess::Position& pos, chess::Move m) con
     const chess::Square t = chess::to(m);
     const uint32_t fl = chess::flags(m);
 
-    const chess::PieceType moved = moved_piece_type_at(pos, us, f);
+    const chess::PieceType moved = pos.piece_type_on(f);
     if (moved == chess::NO_PIECE_TYPE) return out;
 
     // remove moved piece from f, add to t (or promo piece to t)
@@ -55,7 +42,7 @@ MoveDelta CompPST::estimate_delta(const chess::Position& pos, chess::Move m) con
         out.delta += pst(chess::PAWN, cap_sq, them);
         out.valid = true;
     } else if (fl & chess::CAPTURE_MOVE) {
-        const chess::PieceType cpt = captured_piece_type_at(pos, them, t);
+        const chess::PieceType cpt = pos.piece_type_on(t);
         if (cpt != chess::NO_PIECE_TYPE) {
             out.delta += pst(cpt, t, them);
             out.valid = true;
@@ -2,12 +2,12 @@
 
 namespace eval {
 
-PhaseScore CompSpace::value(const chess::Position& pos, chess::Color us) const {
+PhaseScore CompSpace::value(const chess::Position& pos, chess::Color us, const EvalContext& ctx) const {
     const chess::Color them = ~us;
 
     const chess::Bitboard half = opponent_half(us);
-    const chess::Bitboard usAtt = attacks_of(pos, us);
-    const chess::Bitboard themAtt = attacks_of(pos, them);
+    const chess::Bitboard usAtt = ctx.attacks(us);
+    const chess::Bitboard themAtt = ctx.attacks(them);
 
     // "space": squares we control in their half that are not occupied by us and not controlled by them
     chess::Bitboard safe = usAtt & half & ~pos.occupied(us) & ~themAtt;
@@ -20,7 +20,7 @@ PhaseScore CompSpace::value(const chess::Position& pos, chess::Color us) const {
     return {mg, eg};
 }
 
-MoveDelta CompSpace::estimate_delta(const chess::Position& pos, chess::Move m) const {
+MoveDelta CompSpace::estimate_delta(const chess::Position& pos, chess::Move m, const chess::CheckInfo&) const {
     MoveDelta out{};
 
     const chess::Color us = pos.stm;
@@ -28,7 +28,7 @@ MoveDelta CompSpace::estimate_delta(const chess::Position& pos, chess::Move m) c
     const chess::Square t = chess::to(m);
     const uint32_t fl = chess::flags(m);
 
-    const chess::PieceType moved = moved_piece_type_at(pos, us, f);
+    const chess::PieceType moved = pos.piece_type_on(f);
     if (moved != chess::PAWN) return out;
 
     // cheap heuristic: pawn advances into opponent half increase space
@@ -36,8 +36,7 @@ MoveDelta CompSpace::estimate_delta(const chess::Position& pos, chess::Move m) c
     const bool into_half = (half & chess::bb_of(t)) != 0ULL;
 
     if (into_half && (fl == chess::QUIET_MOVE || (fl & chess::DPUSH) || (fl & chess::CAPTURE_MOVE) || (fl & chess::EP))) {
-        out.delta.mg += 12;
-        out.delta.eg += 2;
+        out.delta += PhaseScore{12, 2};
         out.valid = true;
     }
 
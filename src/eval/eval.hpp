@@ -1,26 +1,31 @@
 // src/eval/eval.hpp
 #pragma once
 
+#include <cassert>
+
 #include "../chess/position.hpp"
 #include "../chess/move.hpp"
 #include "../chess/bitboard.hpp"
 
 #include "eval_component.hpp"
 #include "eval_aggregator.hpp"
+#include "eval_tables.hpp"
 
 // components
 #include "component/comp_material.hpp"
 #include "component/comp_pst.hpp"
 #include "component/comp_space.hpp"
-// #include "component/comp_prophylaxis.hpp" // keep off for now (too slow)
+#include "component/comp_pawns.hpp"
+#include "component/comp_prophylaxis.hpp"
 
 namespace eval {
 
 using EngineEval = Aggregator<
     CompMaterial,
     CompPST,
-    CompSpace
-    // ,CompProphylaxis
+    CompSpace,
+    CompPawns,
+    CompProphylaxis
 >;
 
 struct DeltaResult {
@@ -36,43 +41,52 @@ public:
     void on_make_move(const chess::Position& pos, chess::Move m) { agg_.on_make_move(pos, m); }
     void on_unmake_move(const chess::Position& pos, chess::Move m) { agg_.on_unmake_move(pos, m); }
 
+    // cached by Position::key when tables are attached; the key covers everything the
+    // components read
     int eval_stm_cp(const chess::Position& pos) const {
-        PhaseScore ps = agg_.value(pos, pos.stm);
-        return blend(pos, ps);
+        int cp;
+        if (hash_ && hash_->probe(pos.key, cp)) {
+            assert(cp == blend(pos, agg_.value(pos, pos.stm)));
+            return cp;
+        }
+        cp = blend(pos, agg_.value(pos, pos.stm));
+        if (hash_) hash_->store(pos.key, cp);
+        return cp;
     }
 
-    DeltaResult estimate_delta(const chess::Position& pos, chess::Move m) const {
-        MoveDelta d = agg_.estimate_delta(pos, m);
+    // the tables belong to the caller and outlive this evaluator; nullptr = no caching
+    void attach_tables(EvalTables* t) {
+        hash_ = t ? &t->eval : nullptr;
+        agg_.template get<CompPawns>().attach_table(t ? &t->pawns : nullptr);
+        agg_.template get<CompMaterial>().attach_table(t ? &t->material : nullptr);
+    }
+
+    DeltaResult estimate_delta(const chess::Position& pos, chess::Move m, const chess::CheckInfo& ci) const {
+        MoveDelta d = agg_.estimate_delta(pos, m, ci);
         if (!d.valid) return {};
-        return { blend(pos, d.delta), true, d.affects_restriction };
+        return { taper(pos, d.delta), true, d.affects_restriction };
     }
 
 private:
     EngineEval agg_{};
+    EvalHash* hash_ = nullptr; // a cache: eval_stm_cp stays logically const
+
+    // phase and endgame scale come from the material table (one probe per blend).
+    // the scale judges the whole position, so only the full static eval gets it
+    int blend(const chess::Position& pos, PhaseScore ps) const {
+        const MaterialEntry& me = agg_.template get<CompMaterial>().entry(pos);
+        const chess::Color strong = (ps.eg() > 0) ? pos.stm : ~pos.stm;
+        const int eg = ps.eg() * me.scale[strong] / 64;
+        return mix(me.phase, ps.mg(), eg);
+    }
 
-    static int phase256(const chess::Position& pos) {
-        // KN=1, BI=1, RO=2, QU=4; max=24
-        constexpr int wN=1, wB=1, wR=2, wQ=4, maxPhase=24;
-
-        auto cnt = [&](chess::Color c, chess::PieceType pt) -> int {
-            return chess::popcount(pos.pieces[(int)c][(int)pt]);
-        };
-
-        int ph = 0;
-        for (int c = 0; c < 2; ++c) {
-            ph += wN * cnt((chess::Color)c, chess::KNIGHT);
-            ph += wB * cnt((chess::Color)c, chess::BISHOP);
-            ph += wR * cnt((chess::Color)c, chess::ROOK);
-            ph += wQ * cnt((chess::Color)c, chess::QUEEN);
-        }
-
-        if (ph > maxPhase) ph = maxPhase;
-        return (ph * 256 + (maxPhase / 2)) / maxPhase;
+    // phase only: for move deltas, whose sign says nothing about who is winning
+    int taper(const chess::Position& pos, PhaseScore ps) const {
+        return mix(agg_.template get<CompMaterial>().entry(pos).phase, ps.mg(), ps.eg());
     }
 
-    static int blend(const chess::Position& pos, PhaseScore ps) {
-        const int p = phase256(pos);
-        return (ps.mg * p + ps.eg * (256 - p) + 128) >> 8;
+    static int mix(int phase, int mg, int eg) {
+        return (mg * phase + eg * (256 - phase) + 128) >> 8;
     }
 };
 
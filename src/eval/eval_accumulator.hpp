@@ -0,0 +1,101 @@
+// eval/eval_accumulator.hpp
+#pragma once
+
+#include <cassert>
+
+#include "../chess/position.hpp"
+#include "../chess/move.hpp"
+#include "../chess/bitboard.hpp"
+
+#include "eval_component.hpp"
+
+namespace eval {
+
+// running per-colour sum of a per-piece term Psq(pt, sq, colour), for components whose
+// value is exactly that sum. push() applies a move's piece changes (pos is the position
+// *before* the move) after saving the sums; pop() restores them.
+template <PhaseScore (*Psq)(chess::PieceType, chess::Square, chess::Color)>
+class Accumulator {
+public:
+    static constexpr int MAX_DEPTH = 256; // search plies + qsearch captures
+
+    void init(const chess::Position& pos) {
+        compute(pos, side_);
+        top_ = 0;
+    }
+
+    void push(const chess::Position& pos, chess::Move m) {
+        assert(top_ < MAX_DEPTH);
+        stack_[top_][0] = side_[0];
+        stack_[top_][1] = side_[1];
+        ++top_;
+        apply(pos, m);
+    }
+
+    void pop() {
+        assert(top_ > 0);
+        --top_;
+        side_[0] = stack_[top_][0];
+        side_[1] = stack_[top_][1];
+    }
+
+    PhaseScore side(chess::Color c) const { return side_[c]; }
+    PhaseScore diff(chess::Color us) const { return side_[us] - side_[~us]; }
+
+    // from-scratch sums; also the debug reference for the running ones
+    static void compute(const chess::Position& pos, PhaseScore out[2]) {
+        for (int c = 0; c < 2; ++c) {
+            out[c] = {};
+            for (int pt = chess::PAWN; pt <= chess::KING; ++pt) {
+                chess::Bitboard b = pos.pieces[c][pt];
+                while (b) out[c] += Psq(chess::PieceType(pt), chess::pop_lsb(b), chess::Color(c));
+            }
+        }
+    }
+
+    bool matches(const chess::Position& pos) const {
+        PhaseScore ref[2];
+        compute(pos, ref);
+        return ref[0] == side_[0] && ref[1] == side_[1];
+    }
+
+private:
+    PhaseScore side_[2]{};
+    PhaseScore stack_[MAX_DEPTH][2]{};
+    int top_ = 0;
+
+    void apply(const chess::Position& pos, chess::Move m) {
+        const chess::Color us = pos.stm;
+        const chess::Color them = ~us;
+        const chess::Square f = chess::from(m);
+        const chess::Square t = chess::to(m);
+        const uint32_t fl = chess::flags(m);
+        const chess::PieceType pt = pos.piece_type_on(f);
+
+        if (fl & chess::EP) {
+            const chess::Square cap_sq = (us == chess::WHITE) ? (t - 8) : (t + 8);
+            side_[them] -= Psq(chess::PAWN, cap_sq, them);
+        } else if (fl & chess::CAPTURE_MOVE) {
+            const chess::PieceType cpt = pos.piece_type_on(t);
+            if (cpt != chess::NO_PIECE_TYPE) side_[them] -= Psq(cpt, t, them);
+        }
+
+        side_[us] -= Psq(pt, f, us);
+        if (fl & chess::PROMO) {
+            side_[us] += Psq((chess::PieceType)chess::promo(m), t, us);
+        } else {
+            side_[us] += Psq(pt, t, us);
+        }
+
+        if (fl & chess::CASTLE) {
+            // king lands on the g or c file; the rook comes from the h or a file
+            const bool king_side = chess::f_of(t) == 6;
+            const chess::Square rf = chess::mk_sq(king_side ? 7 : 0, chess::r_of(t));
+            const chess::Square rt = chess::mk_sq(king_side ? 5 : 3, chess::r_of(t));
+            side_[us] -= Psq(chess::ROOK, rf, us);
+            side_[us] += Psq(chess::ROOK, rt, us);
+        }
+    }
+};
+
+} // namespace eval
@@ -32,15 +32,18 @@ public:
         tuple_for_each(comps_, [&](auto& c) { c.init(pos); });
     }
 
+    // one context per call: components share its lazily built attack maps and pins
     PhaseScore value(const chess::Position& pos, chess::Color us) const {
+        const EvalContext ctx(pos);
         PhaseScore out{};
         tuple_for_each(
             const_cast<std::tuple<Components...>&>(comps_),
-            [&](auto& c) { out += c.value(pos, us); }
+            [&](auto& c) { out += c.value(pos, us, ctx); }
         );
         return out;
     }
 
+    // pos is the position before m is made; on_unmake_move sees it again once m is undone
     void on_make_move(const chess::Position& pos, chess::Move m) {
         tuple_for_each(comps_, [&](auto& c) { c.on_make_move(pos, m); });
     }
@@ -49,14 +52,15 @@ public:
         tuple_for_each(comps_, [&](auto& c) { c.on_unmake_move(pos, m); });
     }
 
-    MoveDelta estimate_delta(const chess::Position& pos, chess::Move m) const {
+    // ci is check_info(pos), built once per node by the caller and shared by every move
+    MoveDelta estimate_delta(const chess::Position& pos, chess::Move m, const chess::CheckInfo& ci) const {
         MoveDelta out{};
         bool any = false;
 
         tuple_for_each(
             const_cast<std::tuple<Components...>&>(comps_),
             [&](auto& c) {
-                MoveDelta d = c.estimate_delta(pos, m);
+                MoveDelta d = c.estimate_delta(pos, m, ci);
                 if (d.valid) {
                     any = true;
                     out.delta += d.delta;
@@ -69,6 +73,11 @@ public:
         return out;
     }
 
+    template <class C>
+    const C& get() const { return std::get<C>(comps_); }
+    template <class C>
+    C& get() { return std::get<C>(comps_); }
+
 private:
     std::tuple<Components...> comps_{};
 };
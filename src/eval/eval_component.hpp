@@ -3,37 +3,44 @@
 
 #include <cstdint>
 #include "../chess/types.hpp"
+#include "../chess/legality.hpp" // CheckInfo for estimate_delta
+#include "eval_context.hpp"
 
 namespace eval {
 
+// mg and eg packed in one 32-bit int: eg in the high half, mg (sign-extended) in the low
+// half. one add/sub updates both, as long as each half stays within int16.
 struct PhaseScore {
-    int mg = 0;
-    int eg = 0;
+    int32_t v = 0;
+
+    constexpr PhaseScore() = default;
+    constexpr PhaseScore(int mg, int eg) : v(int32_t(uint32_t(eg) << 16) + mg) {}
+
+    constexpr int mg() const { return int16_t(uint16_t(uint32_t(v))); }
+    // +0x8000 undoes the borrow a negative mg took from the high half
+    constexpr int eg() const { return int16_t(uint16_t((uint32_t(v) + 0x8000) >> 16)); }
 };
 
-inline PhaseScore operator+(PhaseScore a, PhaseScore b) {
-    a.mg += b.mg;
-    a.eg += b.eg;
-    return a;
+constexpr PhaseScore packed(int32_t v) {
+    PhaseScore s;
+    s.v = v;
+    return s;
 }
 
-inline PhaseScore& operator+=(PhaseScore& a, PhaseScore b) {
-    a.mg += b.mg;
-    a.eg += b.eg;
-    return a;
-}
+constexpr PhaseScore operator+(PhaseScore a, PhaseScore b) { return packed(a.v + b.v); }
+constexpr PhaseScore operator-(PhaseScore a, PhaseScore b) { return packed(a.v - b.v); }
+constexpr PhaseScore operator-(PhaseScore a) { return packed(-a.v); }
+constexpr PhaseScore operator*(PhaseScore a, int n) { return packed(a.v * n); }
 
-inline PhaseScore operator-(PhaseScore a, PhaseScore b) {
-    a.mg -= b.mg;
-    a.eg -= b.eg;
-    return a;
-}
+constexpr PhaseScore& operator+=(PhaseScore& a, PhaseScore b) { a.v += b.v; return a; }
+constexpr PhaseScore& operator-=(PhaseScore& a, PhaseScore b) { a.v -= b.v; return a; }
 
-inline PhaseScore operator-=(PhaseScore& a, PhaseScore b) {
-    a.mg -= b.mg;
-    a.eg -= b.eg;
-    return a;
-}
+constexpr bool operator==(PhaseScore a, PhaseScore b) { return a.v == b.v; }
+constexpr bool operator!=(PhaseScore a, PhaseScore b) { return a.v != b.v; }
+
+static_assert(PhaseScore(-3, 5).mg() == -3 && PhaseScore(-3, 5).eg() == 5);
+static_assert(PhaseScore(7, -9).mg() == 7 && PhaseScore(7, -9).eg() == -9);
+static_assert((PhaseScore(-100, -200) + PhaseScore(30, 250)).eg() == 50);
 
 struct MoveDelta {
     PhaseScore delta{};
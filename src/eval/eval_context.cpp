@@ -0,0 +1,64 @@
+#include "eval_context.hpp"
+
+#include "../chess/movegen.hpp"
+
+namespace eval {
+
+void EvalContext::build_union() const {
+    chess::Bitboard all[2];
+    chess::attack_maps(pos_, all);
+    attacked_[chess::WHITE][ALL] = all[chess::WHITE];
+    attacked_[chess::BLACK][ALL] = all[chess::BLACK];
+    union_built_ = true;
+}
+
+void EvalContext::build_attacks() const {
+    const chess::Bitboard occ = pos_.occupied();
+
+    for (int c = 0; c < 2; ++c) {
+        chess::Bitboard (&att)[7] = attacked_[c];
+        chess::Bitboard twice = 0ULL;
+
+        // pawns set-wise: a square hit from both diagonals is already attacked twice
+        const chess::Bitboard pawns = pos_.pieces[c][chess::PAWN];
+        const chess::Bitboard east = chess::e_shift(pawns), west = chess::w_shift(pawns);
+        att[chess::PAWN] = chess::pawn_attack_map(pawns, chess::Color(c));
+        twice = (c == chess::WHITE) ? chess::n_shift(east & west) : chess::s_shift(east & west);
+
+        chess::Bitboard all = att[chess::PAWN];
+        auto add = [&](int pt, chess::Bitboard a) {
+            att[pt] |= a;
+            twice |= all & a;
+            all |= a;
+        };
+
+        for (int pt = chess::KNIGHT; pt <= chess::QUEEN; ++pt) {
+            att[pt] = 0ULL;
+            chess::Bitboard b = pos_.pieces[c][pt];
+            while (b) {
+                const chess::Square sq = chess::pop_lsb(b);
+                switch (pt) {
+                    case chess::KNIGHT: add(pt, chess::knight_attacks[sq]);       break;
+                    case chess::BISHOP: add(pt, chess::bishop_attacks(sq, occ)); break;
+                    case chess::ROOK:   add(pt, chess::rook_attacks(sq, occ));   break;
+                    default:            add(pt, chess::queen_attacks(sq, occ));  break;
+                }
+            }
+        }
+
+        att[chess::KING] = 0ULL;
+        add(chess::KING, chess::king_attacks[pos_.king_square(chess::Color(c))]);
+
+        att[ALL] = all;
+        attacked2_[c] = twice;
+    }
+    attacks_built_ = union_built_ = true;
+}
+
+void EvalContext::build_pins() const {
+    pinned_[chess::WHITE] = chess::pinned_pieces(pos_, chess::WHITE);
+    pinned_[chess::BLACK] = chess::pinned_pieces(pos_, chess::BLACK);
+    pins_built_ = true;
+}
+
+} // namespace eval
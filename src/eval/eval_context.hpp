@@ -0,0 +1,68 @@
+// eval/eval_context.hpp
+#pragma once
+
+#include "../chess/position.hpp"
+#include "../chess/bitboard.hpp"
+#include "../chess/attacks.hpp"
+
+namespace eval {
+
+// per-evaluation board facts shared by every component. Aggregator::value builds one
+// per call; the attack maps and pins are only computed the first time a component asks.
+class EvalContext {
+public:
+    static constexpr int ALL = chess::NO_PIECE_TYPE; // attacks(c, ALL): every piece of c
+
+    explicit EvalContext(const chess::Position& pos) : pos_(pos) {}
+
+    const chess::Position& pos() const { return pos_; }
+
+    chess::Bitboard occupied() const { return pos_.occupied(); }
+    chess::Bitboard occupied(chess::Color c) const { return pos_.occupied(c); }
+
+    // squares attacked by c's pieces of type pt (or ALL). the ALL map alone comes from the
+    // set-wise fill; per-type maps need the per-piece pass that also finds double attacks
+    chess::Bitboard attacks(chess::Color c, int pt = ALL) const {
+        if (pt == ALL) {
+            if (!union_built_) build_union();
+        } else if (!attacks_built_) {
+            build_attacks();
+        }
+        return attacked_[c][pt];
+    }
+
+    // squares attacked by at least two of c's pieces (a pawn pair counts)
+    chess::Bitboard attacked_twice(chess::Color c) const {
+        if (!attacks_built_) build_attacks();
+        return attacked2_[c];
+    }
+
+    // c's pieces pinned to c's king
+    chess::Bitboard pinned(chess::Color c) const {
+        if (!pins_built_) build_pins();
+        return pinned_[c];
+    }
+
+    // c's king square and the squares around it
+    chess::Bitboard king_zone(chess::Color c) const {
+        const chess::Square ksq = pos_.king_square(c);
+        return chess::king_attacks[ksq] | chess::bb_of(ksq);
+    }
+
+private:
+    const chess::Position& pos_;
+
+    mutable bool union_built_ = false;
+    mutable bool attacks_built_ = false;
+    mutable bool pins_built_ = false;
+
+    mutable chess::Bitboard attacked_[2][7]{};
+    mutable chess::Bitboard attacked2_[2]{};
+    mutable chess::Bitboard pinned_[2]{};
+
+    void build_union() const;
+    void build_attacks() const;
+    void build_pins() const;
+};
+
+} // namespace eval
@@ -0,0 +1,72 @@
+// eval/eval_hash.hpp
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+namespace eval {
+
+// direct-mapped cache of final side-to-move evals, keyed by Position::key.
+// one 64-bit word per entry: the key's upper 48 bits verify, the low 16 hold the score,
+// so a probe is one load and a store one write. one table per search thread; it outlives
+// the searches that fill it, so later moves of a game start warm.
+class EvalHash {
+public:
+    static constexpr std::size_t DEFAULT_MB = 8;
+
+    // nothing is allocated until the first search
+    EvalHash() = default;
+
+    // a new size takes effect now if the table exists, else at the first search
+    void resize_mb(std::size_t mb) {
+        if (mb == mb_) return;
+        mb_ = mb;
+        if (!table_.empty()) allocate();
+    }
+
+    // before each search: allocates on first use, keeps the entries, resets the counters
+    void new_search() {
+        if (table_.empty()) allocate();
+        probes_ = hits_ = 0;
+    }
+
+    // new game: same size, no entries
+    void clear() { std::fill(table_.begin(), table_.end(), 0ULL); }
+
+    bool probe(std::uint64_t key, int& cp) {
+        const std::uint64_t e = table_[key & mask_];
+        ++probes_;
+        if (e == 0ULL || ((e ^ key) & ~0xFFFFULL)) return false;
+        ++hits_;
+        cp = std::int16_t(std::uint16_t(e));
+        return true;
+    }
+
+    void store(std::uint64_t key, int cp) {
+        if (cp < INT16_MIN || cp > INT16_MAX) return; // not representable; just recompute
+        table_[key & mask_] = (key & ~0xFFFFULL) | std::uint16_t(cp);
+    }
+
+    std::uint64_t probes() const { return probes_; }
+    std::uint64_t hits() const { return hits_; }
+
+private:
+    std::vector<std::uint64_t> table_;
+    std::size_t mb_ = DEFAULT_MB;
+    std::size_t mask_ = 0;
+    std::uint64_t probes_ = 0;
+    std::uint64_t hits_ = 0;
+
+    // largest power-of-two entry count that fits in mb_ (at least one entry)
+    void allocate() {
+        const std::size_t entries = mb_ * 1024ULL * 1024ULL / sizeof(std::uint64_t);
+        std::size_t n = 1;
+        while (n * 2 <= entries) n <<= 1;
+        table_.assign(n, 0ULL);
+        mask_ = n - 1;
+    }
+};
+
+} // namespace eval
@@ -0,0 +1,26 @@
+// eval/eval_tables.hpp
+#pragma once
+
+#include "eval_hash.hpp"
+#include "pawn_hash.hpp"
+#include "material_hash.hpp"
+
+namespace eval {
+
+// the eval caches for one search thread. they outlive the searches that use them
+// (UciState owns them) and are attached to each search's Evaluator, so every move of
+// a game starts with the previous searches' entries.
+struct EvalTables {
+    EvalHash      eval;
+    PawnTable     pawns;
+    MaterialTable material;
+
+    // new game
+    void clear() {
+        eval.clear();
+        pawns.clear();
+        material.clear();
+    }
+};
+
+} // namespace eval
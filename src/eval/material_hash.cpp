@@ -0,0 +1,63 @@
+#include "material_hash.hpp"
+
+namespace eval {
+
+static constexpr int VALUE[5] = {100, 320, 330, 500, 900}; // PAWN..QUEEN
+
+static constexpr PhaseScore BISHOP_PAIR{30, 50};
+static constexpr int KNIGHT_PER_PAWN = 6;  // knights gain with pawns on the board
+static constexpr int ROOK_PER_PAWN   = 12; // rooks gain as pawns come off
+
+static PhaseScore side_imbalance(const int (&n)[6]) {
+    PhaseScore s{};
+    if (n[chess::BISHOP] >= 2) s += BISHOP_PAIR;
+    const int k = n[chess::KNIGHT] * KNIGHT_PER_PAWN * (n[chess::PAWN] - 5);
+    const int r = n[chess::ROOK] * ROOK_PER_PAWN * (5 - n[chess::PAWN]);
+    s += PhaseScore{k + r, k + r};
+    return s;
+}
+
+// eg scale for `strong` when it is ahead: pawnless sides need more than a minor piece to win
+static std::uint8_t side_scale(const int (&strong)[6], const int (&weak)[6]) {
+    if (strong[chess::PAWN]) return 64;
+
+    auto npm = [](const int (&n)[6]) {
+        return n[chess::KNIGHT] * VALUE[chess::KNIGHT] + n[chess::BISHOP] * VALUE[chess::BISHOP]
+             + n[chess::ROOK] * VALUE[chess::ROOK] + n[chess::QUEEN] * VALUE[chess::QUEEN];
+    };
+    const int s = npm(strong), w = npm(weak);
+
+    if (s - w > VALUE[chess::BISHOP]) return 64;
+    if (s < VALUE[chess::ROOK]) return 0;                 // lone minor(s) that cannot mate
+    return (w <= VALUE[chess::BISHOP]) ? 4 : 14;         // e.g. R vs B, R+N vs R
+}
+
+void MaterialTable::evaluate(const chess::Position& pos, MaterialEntry& e) {
+    e.key = pos.material_key;
+    e.filled = true;
+
+    int n[2][6]{};
+    for (int c = 0; c < 2; ++c)
+        for (int p = chess::PAWN; p <= chess::QUEEN; ++p)
+            n[c][p] = chess::popcount(pos.pieces[c][p]);
+
+    int bal = 0;
+    for (int p = chess::PAWN; p <= chess::QUEEN; ++p)
+        bal += VALUE[p] * (n[chess::WHITE][p] - n[chess::BLACK][p]);
+    e.balance = {bal, bal};
+
+    e.imbalance = side_imbalance(n[chess::WHITE]) - side_imbalance(n[chess::BLACK]);
+
+    // KN=1, BI=1, RO=2, QU=4; max=24
+    constexpr int wN = 1, wB = 1, wR = 2, wQ = 4, maxPhase = 24;
+    int ph = 0;
+    for (int c = 0; c < 2; ++c)
+        ph += wN * n[c][chess::KNIGHT] + wB * n[c][chess::BISHOP] + wR * n[c][chess::ROOK] + wQ * n[c][chess::QUEEN];
+    if (ph > maxPhase) ph = maxPhase;
+    e.phase = std::int16_t((ph * 256 + (maxPhase / 2)) / maxPhase);
+
+    e.scale[chess::WHITE] = side_scale(n[chess::WHITE], n[chess::BLACK]);
+    e.scale[chess::BLACK] = side_scale(n[chess::BLACK], n[chess::WHITE]);
+}
+
+} // namespace eval
@@ -0,0 +1,56 @@
+// eval/material_hash.hpp
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+#include "eval_component.hpp"
+#include "../chess/position.hpp"
+
+namespace eval {
+
+// everything that depends only on piece counts
+struct MaterialEntry {
+    std::uint64_t key = 0;
+    PhaseScore    balance{};    // white minus black piece values
+    PhaseScore    imbalance{};  // white minus black: bishop pair, knight/rook vs pawn count
+    std::int16_t  phase = 0;    // 0 (bare endgame) .. 256 (all pieces on)
+    std::uint8_t  scale[2]{64, 64}; // eg multiplier /64 when that colour is the stronger side
+    bool          filled = false;
+};
+
+// direct-mapped, keyed by Position::material_key. one per search thread, owned by the
+// caller (EvalTables) so it stays warm from one search to the next
+class MaterialTable {
+public:
+    static constexpr std::size_t DEFAULT_ENTRIES = 1 << 13;
+
+    explicit MaterialTable(std::size_t entries = DEFAULT_ENTRIES) { resize(entries); }
+
+    void resize(std::size_t entries) {
+        std::size_t n = 1;
+        while (n < entries) n <<= 1;
+        table_.assign(n, MaterialEntry{});
+        mask_ = n - 1;
+    }
+
+    // new game: same size, no entries
+    void clear() { std::fill(table_.begin(), table_.end(), MaterialEntry{}); }
+
+    const MaterialEntry& probe(const chess::Position& pos) {
+        MaterialEntry& e = table_[pos.material_key & mask_];
+        if (e.filled && e.key == pos.material_key) return e;
+        evaluate(pos, e);
+        return e;
+    }
+
+    static void evaluate(const chess::Position& pos, MaterialEntry& e);
+
+private:
+    std::vector<MaterialEntry> table_;
+    std::size_t mask_ = 0;
+};
+
+} // namespace eval
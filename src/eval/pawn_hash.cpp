@@ -0,0 +1,83 @@
+#include "pawn_hash.hpp"
+
+#include "../chess/attacks.hpp"
+
+namespace eval {
+
+// per relative rank (0 = own back rank); rank 1 and 8 never hold pawns
+static constexpr int PASSED_MG[8] = {0, 5, 10, 15, 25, 40, 60, 0};
+static constexpr int PASSED_EG[8] = {0, 10, 15, 25, 45, 70, 110, 0};
+
+static constexpr PhaseScore ISOLATED{-10, -15};
+static constexpr PhaseScore DOUBLED{-10, -20};
+static constexpr PhaseScore BACKWARD{-8, -10};
+
+static inline chess::Bitboard adjacent_files(int f) {
+    const chess::Bitboard file = chess::FILE_A << f;
+    return chess::e_shift(file) | chess::w_shift(file);
+}
+
+// ranks strictly in front of rank r from c's point of view
+static inline chess::Bitboard ranks_ahead(chess::Color c, int r) {
+    if (c == chess::WHITE) return (r == 7) ? 0ULL : (~0ULL << (8 * (r + 1)));
+    return (r == 0) ? 0ULL : ((1ULL << (8 * r)) - 1);
+}
+
+static PhaseScore side_terms(const PawnEntry& e, const chess::Position& pos, chess::Color us) {
+    const chess::Color them = ~us;
+    const chess::Bitboard ours = pos.pieces[us][chess::PAWN];
+    const chess::Bitboard theirs = pos.pieces[them][chess::PAWN];
+
+    PhaseScore s{};
+    chess::Bitboard b = ours;
+    while (b) {
+        const chess::Square sq = chess::pop_lsb(b);
+        const int f = chess::f_of(sq);
+        const int r = chess::r_of(sq);
+        const int rel = (us == chess::WHITE) ? r : 7 - r;
+        const chess::Bitboard file = chess::FILE_A << f;
+        const chess::Bitboard adj = adjacent_files(f);
+        const chess::Bitboard ahead = ranks_ahead(us, r);
+
+        if (e.passed[us] & chess::bb_of(sq)) s += PhaseScore{PASSED_MG[rel], PASSED_EG[rel]};
+
+        const bool isolated = !(ours & adj);
+        if (isolated) s += ISOLATED;
+
+        // the rear pawn of a doubled pair takes the penalty
+        if (ours & file & ahead) s += DOUBLED;
+
+        // backward: its stop square is hit by an enemy pawn and no friendly pawn can ever cover it
+        if (!isolated && rel < 6) {
+            const chess::Square stop = (us == chess::WHITE) ? sq + 8 : sq - 8;
+            const chess::Bitboard sb = chess::bb_of(stop);
+            if ((e.attacks[them] & sb) && !(e.attack_span[us] & sb) && !(theirs & sb)) s += BACKWARD;
+        }
+    }
+    return s;
+}
+
+void PawnTable::evaluate(const chess::Position& pos, PawnEntry& e) {
+    e.key = pos.pawn_key;
+    e.filled = true;
+
+    for (int c = 0; c < 2; ++c) {
+        const chess::Color us = (chess::Color)c;
+        const chess::Bitboard ours = pos.pieces[us][chess::PAWN];
+        e.attacks[us] = chess::pawn_attack_map(ours, us);
+        e.attack_span[us] = (us == chess::WHITE) ? chess::north_fill(e.attacks[us])
+                                                 : chess::south_fill(e.attacks[us]);
+    }
+
+    // passed: no enemy pawn ahead on the same file, and none able to ever capture it
+    const chess::Bitboard wp = pos.pieces[chess::WHITE][chess::PAWN];
+    const chess::Bitboard bp = pos.pieces[chess::BLACK][chess::PAWN];
+    const chess::Bitboard white_blocked = chess::south_fill(chess::s_shift(bp)) | e.attack_span[chess::BLACK];
+    const chess::Bitboard black_blocked = chess::north_fill(chess::n_shift(wp)) | e.attack_span[chess::WHITE];
+    e.passed[chess::WHITE] = wp & ~white_blocked;
+    e.passed[chess::BLACK] = bp & ~black_blocked;
+
+    e.score = side_terms(e, pos, chess::WHITE) - side_terms(e, pos, chess::BLACK);
+}
+
+} // namespace eval
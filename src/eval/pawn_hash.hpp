@@ -0,0 +1,68 @@
+// eval/pawn_hash.hpp
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+#include "eval_component.hpp"
+#include "../chess/position.hpp"
+
+namespace eval {
+
+// everything pawn-only eval needs, computed once per pawn structure
+struct PawnEntry {
+    std::uint64_t   key = 0;
+    PhaseScore      score{};        // white minus black: passed, isolated, doubled, backward
+    chess::Bitboard attacks[2]{};   // squares attacked by each side's pawns now
+    chess::Bitboard attack_span[2]{}; // squares each side's pawns could ever attack by advancing
+    chess::Bitboard passed[2]{};
+    bool            filled = false;
+};
+
+// direct-mapped, keyed by Position::pawn_key. one per search thread, owned by the caller
+// (EvalTables) so it stays warm from one search to the next
+class PawnTable {
+public:
+    static constexpr std::size_t DEFAULT_ENTRIES = 1 << 14;
+
+    explicit PawnTable(std::size_t entries = DEFAULT_ENTRIES) { resize(entries); }
+
+    void resize(std::size_t entries) {
+        std::size_t n = 1;
+        while (n < entries) n <<= 1;
+        table_.assign(n, PawnEntry{});
+        mask_ = n - 1;
+        probes_ = hits_ = 0;
+    }
+
+    // new game: same size, no entries
+    void clear() { std::fill(table_.begin(), table_.end(), PawnEntry{}); }
+
+    // cached entry for pos's pawns, filled on a miss
+    const PawnEntry& probe(const chess::Position& pos) {
+        PawnEntry& e = table_[pos.pawn_key & mask_];
+        ++probes_;
+        if (e.filled && e.key == pos.pawn_key) {
+            ++hits_;
+            return e;
+        }
+        evaluate(pos, e);
+        return e;
+    }
+
+    std::uint64_t probes() const { return probes_; }
+    std::uint64_t hits() const { return hits_; }
+
+    // the pawn-structure terms themselves (no caching)
+    static void evaluate(const chess::Position& pos, PawnEntry& e);
+
+private:
+    std::vector<PawnEntry> table_;
+    std::size_t mask_ = 0;
+    std::uint64_t probes_ = 0;
+    std::uint64_t hits_ = 0;
+};
+
+} // namespace eval
@@ -2,7 +2,7 @@
 #include "chess/attacks.hpp"
 
 int main() {
-    chess::init_attack_tables(); // MUST run once before movegen
+    chess::init_attack_tables(); // magic slider payload; MUST run once before movegen
     uci::loop();
     return 0;
 }
@@ -4,6 +4,7 @@
 #include "../eval/eval.hpp"
 #include "../chess/position.hpp"
 #include "../chess/move.hpp"
+#include "../chess/repetition.hpp"
 
 namespace search {
 
@@ -18,7 +19,12 @@ struct Result {
     int depth = 0;               // depth completed
     std::uint64_t nodes = 0;     // total nodes searched
     int elapsed_ms = 0;
+    std::uint64_t eval_probes = 0; // eval hash lookups / hits during this search
+    std::uint64_t eval_hits = 0;
 };
 
-Result think(chess::Position& pos, const Limits& lim, int movetime_ms = 0);
+// history: keys of the game positions before pos (for repetition draws), may be empty.
+// tables: the caller's eval caches, kept warm across calls; nullptr searches without them
+Result think(chess::Position& pos, const Limits& lim, int movetime_ms = 0,
+             const chess::KeyHistory& history = {}, eval::EvalTables* tables = nullptr);
 } // namespace search
\ No newline at end of file
@@ -4,7 +4,6 @@
 
 #include "search_core.hpp"
 
-#include <vector>
 #include <algorithm>
 
 #include "../chess/movegen.hpp"
@@ -25,12 +24,21 @@ int negamax(State& st, chess::Position& pos, int depth, int alpha, int beta, int
     if (st.time_up()) return 0;
     st.nodes++;
 
+    // draws by rule come before the TT: a stored score knows nothing about the path
+    if (chess::is_repetition(pos, st.keys, ply) || chess::is_fifty_move_draw(pos)) return 0;
+
+    // a reversible move back into the path is available: the side to move can force 0
+    if (alpha < 0 && chess::has_upcoming_repetition(pos, st.keys, ply)) {
+        alpha = 0;
+        if (alpha >= beta) return alpha;
+    }
+
     const int alpha0 = alpha;
 
     chess::Move tt_move = chess::NO_MOVE;
 
 #if USE_TT
-    const std::uint64_t key = chess::compute_key(pos);
+    const std::uint64_t key = pos.key;
 
     if (auto* e = st.tt.probe(key)) {
         if (e->matches(key) && e->depth >= depth) {
@@ -46,45 +54,46 @@ int negamax(State& st, chess::Position& pos, int depth, int alpha, int beta, int
     }
 #endif
 
-    if (depth <= 0) {
+    if (depth <= 0 || ply >= MAX_PLY) {
         return search::util::qsearch(pos, st.eval, alpha, beta);
     }
 
-    std::vector<chess::Move> moves;
-    moves.reserve(256);
-    chess::generate_legal(pos, moves);
+    const bool inCheck = chess::in_check(pos);
+
+    chess::MoveList moves;
+    if (inCheck) chess::generate_evasions(pos, moves);
+    else         chess::generate_legal(pos, moves);
 
     if (moves.empty()) {
         // mate distance should depend on ply for consistent mate scoring + TT mate shifting
-        if (chess::in_check(pos, pos.stm)) return -MATE + ply;
+        if (inCheck) return -MATE + ply;
         return 0;
     }
 
-    std::vector<search::util::ScoredMove> sm;
-    sm.reserve(moves.size());
-    for (auto m : moves) {
-        int sc = search::util::score_move(pos, st.eval, m);
+    const chess::CheckInfo ci = chess::check_info(pos);
+    for (int i = 0; i < moves.count; ++i) {
+        const chess::Move m = moves.moves[i];
+        int sc = search::util::score_move(pos, st.eval, m, ci);
 #if USE_TT
         if (m == tt_move) sc += 10'000'000; // TT move first
 #endif
-        sm.push_back({m, sc});
+        moves.scores[i] = sc;
     }
-    search::util::sort_moves(sm);
+    search::util::sort_moves(moves);
 
     chess::Move bestMove = chess::NO_MOVE;
 
     int idx = 0;
-    for (auto& x : sm) {
+    for (chess::Move m : moves) {
         if (st.stopped) break;
 
-        chess::Move m = x.m;
-
         const bool cap = search::util::is_capture_like(m);
         const int ext  = search::util::extension_for(m);
         const int red  = search::util::lmr_reduction(depth, idx, cap);
 
-        chess::Undo u = chess::do_move(pos, m);
+        st.keys.push(pos.key);
         st.eval.on_make_move(pos, m);
+        chess::do_move(pos, m, st.states[ply]);
 
         int score;
         if (red > 0) {
@@ -96,8 +105,9 @@ int negamax(State& st, chess::Position& pos, int depth, int alpha, int beta, int
             score = -negamax(st, pos, depth - 1 + ext, -beta, -alpha, ply + 1);
         }
 
+        chess::undo_move(pos, m, st.states[ply]);
         st.eval.on_unmake_move(pos, m);
-        chess::undo_move(pos, m, u);
+        st.keys.pop();
 
         if (score >= beta) {
 #if USE_TT
@@ -4,13 +4,17 @@
 #include <chrono>
 
 #include "../chess/position.hpp"
+#include "../chess/make.hpp"
+#include "../chess/repetition.hpp"
 #include "../eval/eval.hpp"
 
 #include "util/tt.hpp"
-#include "../chess/zobrist.hpp" // for chess::compute_key
+#include "../chess/zobrist.hpp"
 
 namespace search {
 
+static constexpr int MAX_PLY = 128;
+
 struct State {
     eval::Evaluator eval;
 
@@ -18,6 +22,12 @@ struct State {
 
     TranspositionTable tt;
 
+    // undo state per ply: states[ply] holds what the move played at ply overwrote
+    chess::StateInfo states[MAX_PLY];
+
+    // game history + search path, pushed before every move and popped after it
+    chess::KeyHistory keys;
+
     // timing
     std::chrono::steady_clock::time_point start;
     int time_limit_ms = 0;   // 0 = ignore
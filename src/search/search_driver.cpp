@@ -1,7 +1,6 @@
 #include "search.hpp"
 #include "search_core.hpp"
 
-#include <vector>
 #include <algorithm>
 
 #include "../chess/movegen.hpp"
@@ -16,12 +15,17 @@ namespace search {
 static constexpr int INF  = 1'000'000;
 static constexpr int MATE = 900'000;
 
-Result think(chess::Position& pos, const Limits& lim, int movetime_ms) {
+Result think(chess::Position& pos, const Limits& lim, int movetime_ms, const chess::KeyHistory& history,
+             eval::EvalTables* tables) {
 
     Result res{};
 
     State st{};
+    if (tables) tables->eval.new_search();
+    st.eval.attach_tables(tables);
     st.eval.init(pos);
+    st.keys = history;
+    st.keys.keys.reserve(st.keys.keys.size() + MAX_PLY);
 
     st.tt.resize_mb(64);
     st.tt.new_search(); // keep your behavior (no clear unless you want it)
@@ -31,13 +35,12 @@ Result think(chess::Position& pos, const Limits& lim, int movetime_ms) {
     st.time_limit_ms = movetime_ms;   // 0 => ignore time limit (assuming time_up handles this)
     st.stopped = false;
 
-    std::vector<chess::Move> root;
-    root.reserve(256);
+    chess::MoveList root;
     chess::generate_legal(pos, root);
 
     if (root.empty()) {
         res.best = chess::NO_MOVE;
-        res.score = chess::in_check(pos, pos.stm) ? -MATE : 0;
+        res.score = chess::in_check(pos) ? -MATE : 0;
         res.depth = 0;
         res.nodes = 0;
         res.elapsed_ms = st.elapsed_ms();
@@ -48,7 +51,7 @@ Result think(chess::Position& pos, const Limits& lim, int movetime_ms) {
     chess::Move root_tt_move = chess::NO_MOVE;
 #if USE_TT
     {
-        const std::uint64_t key = chess::compute_key(pos);
+        const std::uint64_t key = pos.key;
         if (auto* e = st.tt.probe(key)) {
             if (e->matches(key)) root_tt_move = e->best;
         }
@@ -76,34 +79,35 @@ Result think(chess::Position& pos, const Limits& lim, int movetime_ms) {
         const int asp_beta  = beta;
 
         // order root moves (TT move gets a big boost if present)
-        std::vector<search::util::ScoredMove> sm;
-        sm.reserve(root.size());
-        for (auto m : root) {
-            int sc = search::util::score_move(pos, st.eval, m);
+        chess::MoveList sm = root;
+        const chess::CheckInfo ci = chess::check_info(pos);
+        for (int i = 0; i < sm.count; ++i) {
+            const chess::Move m = sm.moves[i];
+            int sc = search::util::score_move(pos, st.eval, m, ci);
 #if USE_TT
             if (m == root_tt_move) sc += 10'000'000;
             if (m == res.best)     sc += 5'000'000; // last iteration PV move
 #endif
-            sm.push_back({m, sc});
+            sm.scores[i] = sc;
         }
         search::util::sort_moves(sm);
 
-        chess::Move bestMove = sm[0].m;
+        chess::Move bestMove = sm[0];
         int bestScore = -INF;
 
         // search root moves
-        for (auto& x : sm) {
+        for (chess::Move m : sm) {
             if (st.stopped) break;
 
-            chess::Move m = x.m;
-
-            chess::Undo u = chess::do_move(pos, m);
+            st.keys.push(pos.key);
             st.eval.on_make_move(pos, m);
+            chess::do_move(pos, m, st.states[0]);
 
             int score = -negamax(st, pos, d - 1, -beta, -alpha, 1);
 
+            chess::undo_move(pos, m, st.states[0]);
             st.eval.on_unmake_move(pos, m);
-            chess::undo_move(pos, m, u);
+            st.keys.pop();
 
             if (st.stopped) break;
 
@@ -127,20 +131,20 @@ Result think(chess::Position& pos, const Limits& lim, int movetime_ms) {
             beta  =  INF;
 
             bestScore = -INF;
-            bestMove  = sm[0].m;
+            bestMove  = sm[0];
 
-            for (auto& x : sm) {
+            for (chess::Move m : sm) {
                 if (st.stopped) break;
 
-                chess::Move m = x.m;
-
-                chess::Undo u = chess::do_move(pos, m);
+                st.keys.push(pos.key);
                 st.eval.on_make_move(pos, m);
+                chess::do_move(pos, m, st.states[0]);
 
                 int score = -negamax(st, pos, d - 1, -beta, -alpha, 1);
 
+                chess::undo_move(pos, m, st.states[0]);
                 st.eval.on_unmake_move(pos, m);
-                chess::undo_move(pos, m, u);
+                st.keys.pop();
 
                 if (st.stopped) break;
 
@@ -174,6 +178,10 @@ Result think(chess::Position& pos, const Limits& lim, int movetime_ms) {
 
     res.nodes = st.nodes;
     res.elapsed_ms = st.elapsed_ms();
+    if (tables) {
+        res.eval_probes = tables->eval.probes();
+        res.eval_hits = tables->eval.hits();
+    }
     return res;
 }
 
@@ -1,44 +1,52 @@
 #pragma once
 
 #include <cstdint>
-#include <vector>
-#include <algorithm>
 
 #include "../../chess/move.hpp"
+#include "../../chess/movelist.hpp"
 #include "../../chess/position.hpp"
+#include "../../chess/legality.hpp" // see_ge
 #include "../../eval/eval.hpp" // for eval::Evaluator delta
 
 namespace search::util {
 
-struct ScoredMove {
-    chess::Move m = 0;
-    int score = 0;
-};
-
-inline void sort_moves(std::vector<ScoredMove>& v) {
-    std::sort(v.begin(), v.end(),
-              [](const ScoredMove& a, const ScoredMove& b) { return a.score > b.score; });
+// descending by ml.scores[]; insertion sort keeps both parallel arrays in step
+// and beats std::sort on lists this short
+inline void sort_moves(chess::MoveList& ml) {
+    for (int i = 1; i < ml.count; ++i) {
+        const chess::Move m = ml.moves[i];
+        const int sc = ml.scores[i];
+        int j = i - 1;
+        while (j >= 0 && ml.scores[j] < sc) {
+            ml.moves[j + 1] = ml.moves[j];
+            ml.scores[j + 1] = ml.scores[j];
+            --j;
+        }
+        ml.moves[j + 1] = m;
+        ml.scores[j + 1] = sc;
+    }
 }
 
 // small helpers
 inline bool is_capture_like(chess::Move m) {
-    const uint32_t fl = chess::flags(m);
-    return (fl & chess::CAPTURE_MOVE) || (fl & chess::EP) || (fl & chess::PROMO);
+    return chess::is_capture(m) || chess::is_promotion(m);
 }
 
-// NOTE: this is *pure* ordering sugar: it does not need SEE yet.
-// It uses eval delta if available + strong bias for captures/promos.
-inline int score_move(const chess::Position& pos, eval::Evaluator& ev, chess::Move m) {
+// NOTE: this is *pure* ordering sugar.
+// It uses eval delta if available + strong bias for captures/promos;
+// captures that lose material by SEE drop out of the capture bucket.
+// ci = check_info(pos), computed once per node rather than once per move.
+inline int score_move(const chess::Position& pos, eval::Evaluator& ev, chess::Move m, const chess::CheckInfo& ci) {
     int s = 0;
     const uint32_t fl = chess::flags(m);
 
     // big buckets first
     if (fl & chess::PROMO)        s += 500000;
     if (fl & chess::EP)           s += 400000;
-    if (fl & chess::CAPTURE_MOVE) s += 300000;
+    if ((fl & chess::CAPTURE_MOVE) && chess::see_ge(pos, m, 0)) s += 300000;
 
     // eval delta seasoning
-    auto d = ev.estimate_delta(pos, m);
+    auto d = ev.estimate_delta(pos, m, ci);
     if (d.valid) {
         s += 1000 * d.cp; // scale so +0.2 pawn matters a bit but doesn't dominate buckets
         if (d.affects_restriction) s += 2500;
@@ -11,29 +11,34 @@ int qsearch(chess::Position& pos, eval::Evaluator& ev, int alpha, int beta) {
     if (stand >= beta) return beta;
     if (stand > alpha) alpha = stand;
 
-    std::vector<chess::Move> moves;
-    moves.reserve(128);
-    chess::generate_legal(pos, moves);
-
-    std::vector<ScoredMove> sm;
-    sm.reserve(moves.size());
-    for (auto m : moves) {
-        if (!is_capture_like(m)) continue;
-        sm.push_back({m, score_move(pos, ev, m)});
+    chess::MoveList moves;
+    chess::generate_captures(pos, moves);
+
+    if (moves.empty()) return alpha;
+
+    // drop captures that lose material outright (promotions always stay)
+    const chess::CheckInfo ci = chess::check_info(pos);
+    int n = 0;
+    for (int i = 0; i < moves.count; ++i) {
+        chess::Move m = moves.moves[i];
+        if (!chess::is_promotion(m) && !chess::see_ge(pos, m, 0)) continue;
+        moves.moves[n] = m;
+        moves.scores[n] = score_move(pos, ev, m, ci);
+        ++n;
     }
+    moves.count = n;
 
-    sort_moves(sm);
+    sort_moves(moves);
 
-    for (auto& x : sm) {
-        chess::Move m = x.m;
-
-        chess::Undo u = chess::do_move(pos, m);
+    for (chess::Move m : moves) {
+        chess::StateInfo si;
         ev.on_make_move(pos, m);
+        chess::do_move(pos, m, si);
 
         int score = -qsearch(pos, ev, -beta, -alpha);
 
+        chess::undo_move(pos, m, si);
         ev.on_unmake_move(pos, m);
-        chess::undo_move(pos, m, u);
 
         if (score >= beta) return beta;
         if (score > alpha) alpha = score;
@@ -37,7 +37,7 @@ void TranspositionTable::store(std::uint64_t key, int depth, TTBound bound,
         // Replace if deeper or entry is from older generation (i.e., stale).
         const bool stale = (e->gen != gen_);
         if (stale || depth >= e->depth) {
-            e->key   = key;
+            e->key   = TTEntry::check_bits(key);
             e->depth = (std::int16_t)depth;
             e->bound = bound;
             e->score = (std::int32_t)to_tt_score(score, ply);
@@ -54,7 +54,7 @@ void TranspositionTable::store(std::uint64_t key, int depth, TTBound bound,
     for (std::size_t i = 0; i < CLUSTER_SIZE; ++i) {
         TTEntry* e = base + i;
         if (e->bound == TTBound::EMPTY) {
-            e->key   = key;
+            e->key   = TTEntry::check_bits(key);
             e->depth = (std::int16_t)depth;
             e->bound = bound;
             e->score = (std::int32_t)to_tt_score(score, ply);
@@ -82,7 +82,7 @@ void TranspositionTable::store(std::uint64_t key, int depth, TTBound bound,
 
     TTEntry* e = base + victim;
 
-    e->key   = key;
+    e->key   = TTEntry::check_bits(key);
     e->depth = (std::int16_t)depth;
     e->bound = bound;
     e->score = (std::int32_t)to_tt_score(score, ply);
@@ -16,16 +16,20 @@ enum class TTBound : std::uint8_t {
     UPPER = 3
 };
 
+// 16 bytes, so a cluster of four fills one cache line
 struct TTEntry {
-    std::uint64_t key = 0;
+    std::uint32_t key = 0;      // upper half of the zobrist key (the lower half picks the cluster)
     std::int32_t  score = 0;    // stored score (mate-adjusted)
+    chess::Move   best = chess::NO_MOVE;
     std::int16_t  depth = -1;   // remaining depth
     TTBound       bound = TTBound::EMPTY;
     std::uint8_t  gen = 0;
-    chess::Move   best = chess::NO_MOVE;
 
-    bool matches(std::uint64_t k) const { return bound != TTBound::EMPTY && key == k; }
+    static std::uint32_t check_bits(std::uint64_t k) { return (std::uint32_t)(k >> 32); }
+
+    bool matches(std::uint64_t k) const { return bound != TTBound::EMPTY && key == check_bits(k); }
 };
+static_assert(sizeof(TTEntry) == 16, "TTEntry should pack into 16 bytes");
 
 class TranspositionTable {
 public:
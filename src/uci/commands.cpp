@@ -4,10 +4,16 @@
 #include <vector>
 #include <iostream>
 #include <cctype>
+#include <algorithm>
+#include <thread>
+#include <chrono>
+#include <cstdlib>
+#include <stdexcept>
 
 #include "../chess/movegen.hpp"
 #include "../chess/make.hpp"
 #include "../chess/attacks.hpp"
+#include "../chess/perft.hpp"
 
 #include "../search/search.hpp"
 
@@ -17,6 +23,16 @@ namespace uci {
 static const char* STARTPOS_FEN =
     "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
 
+// numeric argument; false (instead of a throw out of the command loop) if it isn't one
+static inline bool parse_int(const std::string& s, int& out) {
+    try {
+        out = std::stoi(s);
+        return true;
+    } catch (const std::exception&) {
+        return false;
+    }
+}
+
 static inline std::vector<std::string> split_tokens(const std::string& s) {
     std::istringstream iss(s);
     std::vector<std::string> out;
@@ -85,8 +101,7 @@ static chess::Move parse_uci_move(chess::Position& pos, const std::string& ms) {
     chess::PieceType wantPromo = chess::NO_PIECE_TYPE;
     if (ms.size() == 5) wantPromo = promo_char_to_pt(ms[4]);
 
-    std::vector<chess::Move> moves;
-    moves.reserve(256);
+    chess::MoveList moves;
     chess::generate_legal(pos, moves);
 
     for (auto m : moves) {
@@ -112,6 +127,7 @@ static void cmd_position(UciState& st, const std::vector<std::string>& tok) {
     if (tok.size() < 2) return;
 
     size_t i = 1;
+    st.history.clear();
 
     if (tok[i] == "startpos") {
         st.pos.set_fen(STARTPOS_FEN);
@@ -140,28 +156,61 @@ static void cmd_position(UciState& st, const std::vector<std::string>& tok) {
                 // ignore invalid move tokens rather than crashing
                 continue;
             }
-            chess::Undo u = chess::do_move(st.pos, m);
-            (void)u; // we don't need undo in UCI forward-play
+            chess::StateInfo si; // we don't need undo in UCI forward-play
+            st.history.push(st.pos.key);
+            chess::do_move(st.pos, m, si);
         }
     }
 }
 
+// go perft N: per-move leaf counts, then the total
+static void cmd_perft(UciState& st, int depth) {
+    chess::PerftOptions opt;
+    opt.threads = std::max(1u, std::thread::hardware_concurrency());
+    opt.hash_mb = 64;
+
+    const auto start = std::chrono::steady_clock::now();
+
+    std::uint64_t total = 0;
+    for (const chess::PerftEntry& e : chess::perft_divide(st.pos, depth, opt)) {
+        std::cout << move_to_uci(e.move) << ": " << e.nodes << "\n";
+        total += e.nodes;
+    }
+
+    const auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - start).count();
+
+    std::cout << "\nNodes searched: " << total << "\n";
+    std::cout << "info time " << ms << " nps " << (total * 1000ULL) / std::uint64_t(std::max<long long>(1, ms)) << "\n";
+}
+
 static void cmd_go(UciState& st, const std::vector<std::string>& tok) {
+    if (tok.size() >= 3 && tok[1] == "perft") {
+        int depth = 0;
+        if (!parse_int(tok[2], depth)) {
+            std::cout << "info string bad perft depth " << tok[2] << "\n";
+            return;
+        }
+        cmd_perft(st, std::clamp(depth, 1, chess::MAX_PERFT_DEPTH - 1));
+        return;
+    }
+
     int depth = 6;
     int movetime = 0;
 
     for (size_t i = 1; i < tok.size(); ++i) {
+        // a malformed value leaves the default in place
         if (tok[i] == "depth" && i + 1 < tok.size()) {
-            depth = std::stoi(tok[++i]);
+            parse_int(tok[++i], depth);
         } else if (tok[i] == "movetime" && i + 1 < tok.size()) {
-            movetime = std::stoi(tok[++i]);
+            parse_int(tok[++i], movetime);
         }
     }
 
     search::Limits lim;
     lim.depth = depth;
 
-    search::Result r = search::think(st.pos, lim, movetime);
+    search::Result r = search::think(st.pos, lim, movetime, st.history, &st.tables);
 
     const int ms_for_nps = std::max(1, r.elapsed_ms);
     const int nps = (int)((r.nodes * 1000ULL) / (std::uint64_t)ms_for_nps);
@@ -187,10 +236,23 @@ static void cmd_go(UciState& st, const std::vector<std::string>& tok) {
 
     std::cout << "\n";
 
+    if (r.eval_probes) {
+        std::cout << "info string evalhash hits " << r.eval_hits << "/" << r.eval_probes
+                  << " (" << (r.eval_hits * 100 / r.eval_probes) << "%)\n";
+    }
+
     std::cout << "bestmove " << (r.best == chess::NO_MOVE ? "0000" : move_to_uci(r.best)) << "\n";
 }
 
 
+// setoption name <name> value <v>
+static void cmd_setoption(UciState& st, const std::vector<std::string>& tok) {
+    if (tok.size() < 5 || tok[1] != "name" || tok[3] != "value") return;
+    if (tok[2] == "EvalHash") {
+        st.tables.eval.resize_mb((std::size_t)std::clamp(std::atoi(tok[4].c_str()), 1, 1024));
+    }
+}
+
 bool handle_command(UciState& st, const std::string& line) {
     auto tok = split_tokens(line);
     if (tok.empty()) return true;
@@ -200,6 +262,7 @@ bool handle_command(UciState& st, const std::string& line) {
     if (cmd == "uci") {
         std::cout << "id name annihilator\n";
         std::cout << "id author adi\n";
+        std::cout << "option name EvalHash type spin default 8 min 1 max 1024\n";
         std::cout << "uciok\n";
         return true;
     }
@@ -209,8 +272,15 @@ bool handle_command(UciState& st, const std::string& line) {
         return true;
     }
 
+    if (cmd == "setoption") {
+        cmd_setoption(st, tok);
+        return true;
+    }
+
     if (cmd == "ucinewgame") {
         st.pos.set_fen(STARTPOS_FEN);
+        st.history.clear();
+        st.tables.clear();
         return true;
     }
 
@@ -2,11 +2,15 @@
 
 #include <string>
 #include "../chess/position.hpp"
+#include "../chess/repetition.hpp"
+#include "../eval/eval_tables.hpp"
 
 namespace uci {
 
 struct UciState {
     chess::Position pos;
+    chess::KeyHistory history; // keys of the positions before pos, for repetition draws
+    eval::EvalTables tables;   // eval caches kept across go commands; setoption name EvalHash
 };
 
 bool handle_command(UciState& st, const std::string& line);
@@ -1,96 +1,646 @@
 #include <iostream>
+#include <fstream>
+#include <sstream>
 #include <vector>
 #include <string>
 #include <chrono>
+#include <thread>
+#include <algorithm>
 
 #include "position.hpp"
 #include "movegen.hpp"
 #include "make.hpp"
 #include "attacks.hpp"
+#include "legality.hpp"
+#include "perft.hpp"
+#include "fen_batch.hpp"
+#include "repetition.hpp"
+#include "eval/eval_context.hpp"
 
 using namespace chess;
 
-static uint64_t perft(Position& pos, int depth) {
+static constexpr int MAX_DEPTH = 64;
+
+// make/unmake: st[0] receives the undo state for this ply, st[1] is handed to the child
+static uint64_t perft(Position& pos, int depth, StateInfo* st) {
     if (depth == 0) return 1;
 
-    std::vector<Move> moves;
-    moves.reserve(256);
+    MoveList moves;
     generate_legal(pos, moves);
 
     uint64_t nodes = 0;
     for (Move m : moves) {
-        Undo u = do_move(pos, m);
-        nodes += perft(pos, depth - 1);
-        undo_move(pos, m, u);
+        do_move(pos, m, *st);
+        nodes += perft(pos, depth - 1, st + 1);
+        undo_move(pos, m, *st);
     }
     return nodes;
 }
 
-static void perft_divide(Position& pos, int depth) {
-    std::vector<Move> moves;
-    moves.reserve(256);
-    generate_legal(pos, moves);
+// copy-make: each child is written into the next slot, so undo is just returning
+static uint64_t perft_copy(Position* pos, int depth) {
+    if (depth == 0) return 1;
+
+    MoveList moves;
+    generate_legal(pos[0], moves);
 
-    uint64_t total = 0;
+    uint64_t nodes = 0;
     for (Move m : moves) {
-        Undo u = do_move(pos, m);
-        uint64_t n = perft(pos, depth - 1);
-        undo_move(pos, m, u);
-        total += n;
+        do_move_copy(pos[0], pos[1], m);
+        nodes += perft_copy(pos + 1, depth - 1);
+    }
+    return nodes;
+}
+
+// walks the tree checking that the staged generators partition generate_legal
+static bool staged_matches(Position& pos, int depth) {
+    MoveList all, caps, quiets;
+    generate_legal(pos, all);
+    generate_captures(pos, caps);
+    generate_quiets(pos, quiets);
 
-        std::cout << from(m) << "->" << to(m) << " : " << n << "\n";
+    if (caps.size() + quiets.size() != all.size()) return false;
+    for (Move m : caps)   if (!all.contains(m)) return false;
+    for (Move m : quiets) if (!all.contains(m)) return false;
+
+    if (in_check(pos, pos.stm)) {
+        MoveList ev;
+        generate_evasions(pos, ev);
+        if (ev.size() != all.size()) return false;
     }
-    std::cout << "total: " << total << "\n";
+
+    if (depth <= 1) return true;
+    for (Move m : all) {
+        StateInfo st;
+        do_move(pos, m, st);
+        bool ok = staged_matches(pos, depth - 1);
+        undo_move(pos, m, st);
+        if (!ok) return false;
+    }
+    return true;
 }
 
-static void run_test(const std::string& name,
-                     const std::string& fen,
-                     int depth) {
-    Position p;
-    p.set_fen(fen);
+// walks the tree checking gives_check against make + in_check
+static bool checks_match(Position& pos, int depth) {
+    MoveList all;
+    generate_legal(pos, all);
+    const CheckInfo ci = check_info(pos);
+
+    for (Move m : all) {
+        const bool predicted = gives_check(pos, m, ci);
+        StateInfo st;
+        do_move(pos, m, st);
+        bool ok = predicted == in_check(pos, pos.stm) && predicted == in_check(pos);
+        if (ok && depth > 1) ok = checks_match(pos, depth - 1);
+        undo_move(pos, m, st);
+        if (!ok) return false;
+    }
+    return true;
+}
+
+// walks the tree checking see_ge against the full swap list at thresholds around it
+static bool see_matches(Position& pos, int depth) {
+    MoveList all;
+    generate_legal(pos, all);
+
+    for (Move m : all) {
+        const int v = see(pos, m);
+        for (int t : {v - 1, v, v + 1, -SEE_VALUE[QUEEN], 0, SEE_VALUE[PAWN], SEE_VALUE[ROOK]}) {
+            if (see_ge(pos, m, t) != (v >= t)) return false;
+        }
+        if (depth > 1) {
+            StateInfo st;
+            do_move(pos, m, st);
+            const bool ok = see_matches(pos, depth - 1);
+            undo_move(pos, m, st);
+            if (!ok) return false;
+        }
+    }
+    return true;
+}
+
+static Square square_of(const char* s) {
+    return mk_sq(s[0] - 'a', s[1] - '1');
+}
+
+// hand-checked exchanges; promotions are scored as the pawn that moved
+static bool see_values_match() {
+    struct SeeCase { const char* fen; const char* from; const char* to; int value; };
+    static const SeeCase cases[] = {
+        {"4k3/8/8/3p4/4P3/8/8/4K3 w - - 0 1",          "e4", "d5",  100}, // free pawn
+        {"4k3/8/2p5/3p4/4P3/8/8/4K3 w - - 0 1",        "e4", "d5",    0}, // pawn for pawn
+        {"4k3/8/2p5/3p4/8/8/3R4/4K3 w - - 0 1",        "d2", "d5", -400}, // rook for pawn
+        {"4k3/3r4/8/3p4/8/8/3R4/3R2K1 w - - 0 1",      "d2", "d5",  100}, // x-ray rook behind
+        {"4k3/8/2p5/8/8/8/3R4/4K3 w - - 0 1",          "d2", "d5", -500}, // quiet onto a pawn
+        {"r3k3/1P6/8/8/8/8/8/4K3 w - - 0 1",           "b7", "a8",  500}, // capture-promotion
+        {"1r2k3/P7/8/8/8/8/8/4K3 w - - 0 1",           "a7", "a8", -100}, // promotion en prise
+        {"4k3/8/8/3pP3/8/8/8/4K3 w - d6 0 1",          "e5", "d6",  100}, // en passant
+        {"4k3/2p5/8/3pP3/8/8/8/4K3 w - d6 0 1",        "e5", "d6",    0}, // en passant, retaken
+    };
 
-    std::cout << "\n== " << name << " ==\n";
+    bool ok = true;
+    for (const SeeCase& c : cases) {
+        Position pos;
+        pos.set_fen(c.fen);
 
-    auto start = std::chrono::high_resolution_clock::now();
+        MoveList moves;
+        generate_legal(pos, moves);
+        Move m = NO_MOVE;
+        for (Move x : moves) {
+            if (from(x) == square_of(c.from) && to(x) == square_of(c.to)
+                && (!is_promotion(x) || promo(x) == QUEEN)) m = x;
+        }
 
-    uint64_t nodes = perft(p, depth);
+        const int v = (m == NO_MOVE) ? -1 : see(pos, m);
+        if (v != c.value || !see_ge(pos, m, c.value) || see_ge(pos, m, c.value + 1)) {
+            std::cout << "see " << c.from << c.to << " in " << c.fen << ": expected " << c.value
+                      << " got " << v << "\n";
+            ok = false;
+        }
+    }
+    return ok;
+}
 
-    auto end = std::chrono::high_resolution_clock::now();
-    double seconds =
-        std::chrono::duration<double>(end - start).count();
+// walks the tree checking count_legal_moves against generate_legal for both colours;
+// the side not to move is counted on a copy with stm flipped (and so no EP capture)
+static bool legal_counts_match(Position& pos, int depth) {
+    MoveList all;
+    generate_legal(pos, all);
+    if (count_legal_moves(pos, pos.stm) != all.size()) return false;
 
-    double nps = nodes / seconds;
+    Position other = pos;
+    other.stm = ~pos.stm;
+    other.en_passant_square = NO_SQUARE;
+    other.checkers = attackers_to(other, other.king_square(other.stm), other.occ[OCC_BOTH]) & other.occ[pos.stm];
+    MoveList theirs;
+    generate_legal(other, theirs);
+    if (count_legal_moves(pos, ~pos.stm) != theirs.size()) return false;
 
-    std::cout << "depth = " << depth << "\n";
-    std::cout << "nodes = " << nodes << "\n";
-    std::cout << "time  = " << seconds << " sec\n";
-    std::cout << "nps   = " << (uint64_t)nps << "\n";
+    if (depth <= 1) return true;
+    for (Move m : all) {
+        StateInfo st;
+        do_move(pos, m, st);
+        const bool ok = legal_counts_match(pos, depth - 1);
+        undo_move(pos, m, st);
+        if (!ok) return false;
+    }
+    return true;
 }
 
+// per-piece magic lookups: the reference for the set-wise fills in attack_maps
+static Bitboard attack_map_ref(const Position& pos, Color c, Bitboard& sliders) {
+    const Bitboard occ = pos.occupied();
+    sliders = 0ULL;
+    Bitboard b = pos.pieces[c][BISHOP] | pos.pieces[c][QUEEN];
+    while (b) sliders |= bishop_attacks(pop_lsb(b), occ);
+    b = pos.pieces[c][ROOK] | pos.pieces[c][QUEEN];
+    while (b) sliders |= rook_attacks(pop_lsb(b), occ);
+
+    Bitboard a = sliders | pawn_attack_map(pos, c) | king_attacks[pos.king_square(c)];
+    b = pos.pieces[c][KNIGHT];
+    while (b) a |= knight_attacks[pop_lsb(b)];
+    return a;
+}
 
-int main() {
+// walks the tree checking whichever fill this build selected against the magic union
+static bool attack_maps_match(Position& pos, int depth) {
+    Bitboard maps[2];
+    attack_maps(pos, maps);
+    for (Color c : {WHITE, BLACK}) {
+        Bitboard sliders;
+        const Bitboard ref = attack_map_ref(pos, c, sliders);
+        const Bitboard diag = pos.pieces[c][BISHOP] | pos.pieces[c][QUEEN];
+        const Bitboard orth = pos.pieces[c][ROOK] | pos.pieces[c][QUEEN];
+        if (maps[c] != ref || attack_map(pos, c) != ref) return false;
+        if (slider_attack_map(diag, orth, pos.occupied()) != sliders) return false;
+    }
+    if (depth <= 1) return true;
+
+    MoveList all;
+    generate_legal(pos, all);
+    for (Move m : all) {
+        StateInfo st;
+        do_move(pos, m, st);
+        const bool ok = attack_maps_match(pos, depth - 1);
+        undo_move(pos, m, st);
+        if (!ok) return false;
+    }
+    return true;
+}
+
+// eval::EvalContext's maps rebuilt piece by piece: attacks per type, squares hit by two
+// or more pieces, pins found by lifting each piece off the king's lines
+static bool context_matches_pieces(const Position& pos) {
+    const Bitboard occ = pos.occupied();
+    const eval::EvalContext by_type(pos), union_only(pos);
+
+    for (Color c : {WHITE, BLACK}) {
+        Bitboard att[6] = {}, all = 0ULL, twice = 0ULL;
+        for (int pt = PAWN; pt <= KING; ++pt) {
+            for (Bitboard b = pos.pieces[c][pt]; b; ) {
+                const Square sq = pop_lsb(b);
+                Bitboard a;
+                switch (pt) {
+                    case PAWN:   a = pawn_attacks[c][sq];         break;
+                    case KNIGHT: a = knight_attacks[sq];          break;
+                    case BISHOP: a = bishop_attacks(sq, occ);     break;
+                    case ROOK:   a = rook_attacks(sq, occ);       break;
+                    case QUEEN:  a = queen_attacks(sq, occ);      break;
+                    default:     a = king_attacks[sq];            break;
+                }
+                att[pt] |= a;
+                twice |= all & a;
+                all |= a;
+            }
+            if (by_type.attacks(c, pt) != att[pt]) return false;
+        }
+        if (by_type.attacks(c) != all || union_only.attacks(c) != all) return false;
+        if (by_type.attacked_twice(c) != twice) return false;
+
+        const Square ksq = pos.king_square(c);
+        const Bitboard diag = pos.pieces[~c][BISHOP] | pos.pieces[~c][QUEEN];
+        const Bitboard orth = pos.pieces[~c][ROOK] | pos.pieces[~c][QUEEN];
+        const Bitboard seen = (bishop_attacks(ksq, occ) & diag) | (rook_attacks(ksq, occ) & orth);
+        Bitboard pinned = 0ULL;
+        for (Bitboard b = pos.occ[c] & ~bb_of(ksq); b; ) {
+            const Bitboard x = bb_of(pop_lsb(b));
+            const Bitboard lifted = (bishop_attacks(ksq, occ ^ x) & diag) | (rook_attacks(ksq, occ ^ x) & orth);
+            if (lifted & ~seen) pinned |= x;
+        }
+        if (by_type.pinned(c) != pinned) return false;
+        if (by_type.king_zone(c) != (king_attacks[ksq] | bb_of(ksq))) return false;
+    }
+    return true;
+}
+
+static bool context_matches(Position& pos, int depth) {
+    if (!context_matches_pieces(pos)) return false;
+    if (depth <= 1) return true;
+
+    MoveList all;
+    generate_legal(pos, all);
+    for (Move m : all) {
+        StateInfo st;
+        do_move(pos, m, st);
+        const bool ok = context_matches(pos, depth - 1);
+        undo_move(pos, m, st);
+        if (!ok) return false;
+    }
+    return true;
+}
+
+// knight shuffles from the start position, the fifty-move rule and mate on the 100th ply
+static bool draw_rules_match() {
+    bool ok = true;
+    auto expect = [&](const char* what, bool got, bool want) {
+        if (got != want) { std::cout << what << ": expected " << want << " got " << got << "\n"; ok = false; }
+    };
+
+    const char* shuffle[] = {"g1f3", "g8f6", "f3g1", "f6g8", "g1f3", "g8f6", "f3g1", "f6g8"};
+    Position pos;
+    pos.set_fen("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1");
+    KeyHistory hist;
+    StateInfo st[8];
+    for (int i = 0; i < 8; ++i) {
+        hist.push(pos.key);
+        do_move(pos, make_move(square_of(shuffle[i]), square_of(shuffle[i] + 2)), st[i]);
+
+        if (i == 2) {
+            // black's f6g8 would restore the start position three plies back
+            expect("upcoming, cycle from the root", has_upcoming_repetition(pos, hist, 3), false);
+            expect("upcoming, cycle inside search", has_upcoming_repetition(pos, hist, 4), true);
+        }
+        if (i == 3) {
+            expect("root repeated once", is_repetition(pos, hist, 4), false);
+            expect("upcoming, g1f3 again", has_upcoming_repetition(pos, hist, 4), true);
+        }
+        if (i == 4) {
+            expect("repeat inside search", is_repetition(pos, hist, 5), true);
+            expect("repeat of the root", is_repetition(pos, hist, 4), false);
+        }
+        if (i == 7) expect("third occurrence", is_repetition(pos, hist, 4), true);
+    }
+
+    struct FiftyCase { const char* fen; bool draw; };
+    static const FiftyCase fifty[] = {
+        {"4k3/8/8/8/8/8/8/4K2R w - - 99 80",  false},
+        {"4k3/8/8/8/8/8/8/4K2R w - - 100 80", true},
+        {"R3k3/8/8/8/8/8/8/4K3 b - - 100 80", true},  // in check, can step out
+        {"R3k3/8/4K3/8/8/8/8/8 b - - 100 80", false}, // mated on the 100th
+    };
+    for (const FiftyCase& c : fifty) {
+        Position p;
+        p.set_fen(c.fen);
+        expect(c.fen, is_fifty_move_draw(p), c.draw);
+    }
+    return ok;
+}
+
+struct SuiteCase {
+    std::string name;
+    std::string fen;
+    std::vector<std::pair<int, uint64_t>> expected; // (depth, nodes), ascending depth
+};
+
+struct CaseResult {
+    const SuiteCase* c;
+    int depth = 0;
+    uint64_t nodes = 0;
+    uint64_t expected = 0;
+    double seconds = 0.0;
+    bool ok = true;
+    bool skipped = false; // --max-depth is below every listed depth; nothing was checked
+};
+
+static const char* status_of(const CaseResult& r) {
+    return r.skipped ? "skip" : r.ok ? "ok" : "fail";
+}
+
+static std::string trim(const std::string& s) {
+    const size_t b = s.find_first_not_of(" \t\r\n");
+    if (b == std::string::npos) return "";
+    const size_t e = s.find_last_not_of(" \t\r\n");
+    return s.substr(b, e - b + 1);
+}
+
+// one case per line: <fen> ;D<depth> <nodes> ... ;id <name>. '#' starts a comment line.
+static bool load_suite(const std::string& path, std::vector<SuiteCase>& out) {
+    std::ifstream in(path);
+    if (!in) return false;
+
+    std::string line;
+    while (std::getline(in, line)) {
+        line = trim(line);
+        if (line.empty() || line[0] == '#') continue;
+
+        std::istringstream fields(line);
+        SuiteCase c;
+        std::string field;
+        std::getline(fields, field, ';');
+        c.fen = trim(field);
+
+        while (std::getline(fields, field, ';')) {
+            std::istringstream op(field);
+            std::string tag;
+            op >> tag;
+            if (tag == "id") {
+                op >> c.name;
+            } else if (tag.size() >= 2 && tag[0] == 'D') {
+                uint64_t nodes = 0;
+                if (op >> nodes) c.expected.emplace_back(std::stoi(tag.substr(1)), nodes);
+            }
+        }
+        if (c.name.empty()) c.name = "case" + std::to_string(out.size() + 1);
+        std::sort(c.expected.begin(), c.expected.end());
+        if (!c.expected.empty()) out.push_back(c);
+    }
+    return true;
+}
+
+static std::string json_escape(const std::string& s) {
+    std::string out;
+    for (char ch : s) {
+        if (ch == '"' || ch == '\\') out.push_back('\\');
+        out.push_back(ch);
+    }
+    return out;
+}
+
+static void write_report(const std::string& path, const std::string& suite, const PerftOptions& opt,
+                         const std::vector<CaseResult>& results) {
+    std::ofstream out(path);
+    uint64_t total_nodes = 0;
+    double total_sec = 0.0;
+    bool passed = true;
+    int passed_count = 0;
+    int skipped = 0;
+
+    out << "{\n";
+    out << "  \"suite\": \"" << json_escape(suite) << "\",\n";
+    out << "  \"threads\": " << opt.threads << ",\n";
+    out << "  \"hash_mb\": " << opt.hash_mb << ",\n";
+    out << "  \"positions\": [\n";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const CaseResult& r = results[i];
+        total_nodes += r.nodes;
+        total_sec += r.seconds;
+        if (r.skipped) {
+            ++skipped;
+        } else {
+            passed = passed && r.ok;
+            passed_count += r.ok;
+        }
+
+        out << "    {\"name\": \"" << json_escape(r.c->name) << "\""
+            << ", \"fen\": \"" << json_escape(r.c->fen) << "\""
+            << ", \"depth\": " << r.depth
+            << ", \"nodes\": " << r.nodes
+            << ", \"expected\": " << r.expected
+            << ", \"ok\": " << (r.ok && !r.skipped ? "true" : "false")
+            << ", \"status\": \"" << status_of(r) << "\""
+            << ", \"time_sec\": " << r.seconds
+            << ", \"nps\": " << (uint64_t)(r.nodes / std::max(r.seconds, 1e-9))
+            << "}" << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    out << "  ],\n";
+    out << "  \"total_nodes\": " << total_nodes << ",\n";
+    out << "  \"total_time_sec\": " << total_sec << ",\n";
+    out << "  \"nps\": " << (uint64_t)(total_nodes / std::max(total_sec, 1e-9)) << ",\n";
+    out << "  \"passed_count\": " << passed_count << ",\n";
+    out << "  \"skipped\": " << skipped << ",\n";
+    out << "  \"passed\": " << (passed ? "true" : "false") << "\n";
+    out << "}\n";
+}
+
+// the batch loader must give the same positions, in file order, as parse_fen on each line
+static bool batch_matches(const std::string& path, const std::vector<SuiteCase>& cases) {
+    std::vector<Position> batch;
+    const FenBatchResult res = load_fen_file(path, batch);
+    if (!res.opened || res.failed != 0 || batch.size() != cases.size()) return false;
+
+    for (std::size_t i = 0; i < cases.size(); ++i) {
+        Position p;
+        p.parse_fen(cases[i].fen);
+        if (batch[i].fen() != p.fen() || batch[i].key != p.key || batch[i].material_key != p.material_key) return false;
+    }
+    return true;
+}
+
+// inputs parse_fen has to refuse rather than index past its tables
+static bool bad_fens_rejected() {
+    struct BadFen { const char* fen; FenError err; };
+    static const BadFen cases[] = {
+        {"4k3/8/8/3pP3/8/8/8/4K3 w - d5 0 1",          FenError::BAD_EP},        // not behind the pawn
+        {"4k3/8/8/8/3Pp3/8/8/4K3 b - d6 0 1",          FenError::BAD_EP},        // wrong side's rank
+        {"4k3/8/8/3nP3/8/8/8/4K3 w - d6 0 1",          FenError::BAD_EP},        // knight, not a pawn, on d5
+        {"4k3/3p4/8/3pP3/8/8/8/4K3 w - d6 0 1",        FenError::BAD_EP},        // d7 still occupied
+        {"4k3/8/8/8/8/8/8/4K3 w K - 0 1",              FenError::BAD_CASTLING},  // no rook on h1
+        {"4k3/8/8/8/8/8/8/3K3R w K - 0 1",             FenError::BAD_CASTLING},  // king off e1
+        {"r3k3/8/8/8/8/8/8/4K3 w k - 0 1",             FenError::BAD_CASTLING},  // rook on a8, not h8
+        {"4k3/8/8/8/8/8/PPPPPPPP/PPPPK3 w - - 0 1",    FenError::BAD_PLACEMENT}, // 12 pawns
+        {"QQQQQQQQ/QQQ5/8/8/8/8/8/4K2k w - - 0 1",     FenError::BAD_PLACEMENT}, // 11 queens
+    };
+
+    bool ok = true;
+    for (const BadFen& c : cases) {
+        Position p;
+        const FenError err = p.parse_fen(c.fen);
+        if (err != c.err) {
+            std::cout << "parse_fen(" << c.fen << ") gives " << fen_error_name(err) << "\n";
+            ok = false;
+        }
+    }
+    return ok;
+}
+
+static double seconds_since(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// checks every listed depth with the perft engine and times the deepest one
+static CaseResult run_case(const SuiteCase& c, const PerftOptions& opt, int max_depth, bool strategies) {
+    CaseResult r;
+    r.c = &c;
+
+    Position p;
+    const FenError err = p.parse_fen(c.fen);
+    if (err != FenError::OK) {
+        std::cout << c.name << ": " << fen_error_name(err) << "\n";
+        r.ok = false;
+        return r;
+    }
+    if (p.fen() != c.fen) {
+        std::cout << c.name << ": fen round trip gives " << p.fen() << "\n";
+        r.ok = false;
+    }
+
+    for (const auto& [depth, expected] : c.expected) {
+        if (depth > max_depth) break;
+
+        const auto start = std::chrono::steady_clock::now();
+        const uint64_t nodes = chess::perft(p, depth, opt);
+        r.seconds = seconds_since(start);
+        r.depth = depth;
+        r.nodes = nodes;
+        r.expected = expected;
+
+        if (nodes != expected) {
+            std::cout << c.name << ": depth " << depth << " expected " << expected << " got " << nodes << "\n";
+            r.ok = false;
+            return r;
+        }
+    }
+    if (r.depth == 0) {
+        r.skipped = true;
+        return r;
+    }
+
+    // the raw make/unmake and copy-make walkers, without bulk counting or hash
+    if (strategies && r.depth > 0) {
+        StateInfo st[MAX_DEPTH];
+        auto start = std::chrono::steady_clock::now();
+        const uint64_t made = perft(p, r.depth, st);
+        const double make_sec = seconds_since(start);
+
+        static Position stack[MAX_DEPTH];
+        stack[0] = p;
+        start = std::chrono::steady_clock::now();
+        const uint64_t copied = perft_copy(stack, r.depth);
+        const double copy_sec = seconds_since(start);
+
+        std::cout << "  make nps " << (uint64_t)(made / make_sec)
+                  << "  copy nps " << (uint64_t)(copied / copy_sec) << "\n";
+        if (made != r.nodes || copied != r.nodes || p.fen() != c.fen) r.ok = false;
+    }
+
+    if (!staged_matches(p, 3))     { std::cout << c.name << ": staged generators disagree\n";  r.ok = false; }
+    if (!checks_match(p, 3))       { std::cout << c.name << ": gives_check disagrees\n";       r.ok = false; }
+    if (!see_matches(p, 2))        { std::cout << c.name << ": see_ge disagrees with see\n";   r.ok = false; }
+    if (!attack_maps_match(p, 3))  { std::cout << c.name << ": attack maps disagree\n";        r.ok = false; }
+    if (!legal_counts_match(p, 3)) { std::cout << c.name << ": count_legal_moves disagrees\n"; r.ok = false; }
+    if (!context_matches(p, 3))    { std::cout << c.name << ": eval context disagrees\n";      r.ok = false; }
+    return r;
+}
+
+// usage: perft [suite.epd] [--json report.json] [--threads N] [--hash MB] [--max-depth D] [--strategies]
+//        perft divide <depth> [fen]
+int main(int argc, char** argv) {
     init_attack_tables();
 
-    // Start position
-    run_test(
-        "startpos",
-        "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
-        6
-    );
-
-    // Kiwipete (castling/pins stress)
-    run_test(
-        "kiwipete",
-        "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
-        4
-    );
-
-    // EP legality stress
-    run_test(
-        "ep_test",
-        "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
-        7
-    );
-
-    return 0;
+    if (!verify_slider_tables()) {
+        std::cout << "magic slider tables disagree with ray reference\n";
+        return 1;
+    }
+    if (!see_values_match()) return 1;
+    if (!draw_rules_match()) return 1;
+
+    PerftOptions opt;
+    opt.threads = std::max(1u, std::thread::hardware_concurrency());
+
+    if (argc >= 3 && std::string(argv[1]) == "divide") {
+        Position pos;
+        const std::string fen = (argc >= 4) ? argv[3] : "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
+        if (!pos.set_fen(fen)) {
+            std::cout << "bad fen: " << fen << "\n";
+            return 1;
+        }
+        opt.hash_mb = 64;
+        uint64_t total = 0;
+        for (const PerftEntry& e : perft_divide(pos, std::stoi(argv[2]), opt)) {
+            std::cout << from(e.move) << "->" << to(e.move) << " : " << e.nodes << "\n";
+            total += e.nodes;
+        }
+        std::cout << "total: " << total << "\n";
+        return 0;
+    }
+
+    std::string suite = "tests/perft.epd";
+    std::string json = "perft_report.json";
+    int max_depth = MAX_DEPTH;
+    bool strategies = false;
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string a = argv[i];
+        if (a == "--json" && i + 1 < argc) json = argv[++i];
+        else if (a == "--threads" && i + 1 < argc) opt.threads = std::max(1, std::stoi(argv[++i]));
+        else if (a == "--hash" && i + 1 < argc) opt.hash_mb = (std::size_t)std::stoul(argv[++i]);
+        else if (a == "--max-depth" && i + 1 < argc) max_depth = std::stoi(argv[++i]);
+        else if (a == "--strategies") strategies = true;
+        else suite = a;
+    }
+
+    std::vector<SuiteCase> cases;
+    if (!load_suite(suite, cases) || cases.empty()) {
+        std::cout << "cannot read suite " << suite << "\n";
+        return 1;
+    }
+    if (!bad_fens_rejected()) return 1;
+    if (!batch_matches(suite, cases)) {
+        std::cout << "load_fen_file disagrees with parse_fen on " << suite << "\n";
+        return 1;
+    }
+
+    std::vector<CaseResult> results;
+    int failed = 0;
+    int skipped = 0;
+    for (const SuiteCase& c : cases) {
+        CaseResult r = run_case(c, opt, max_depth, strategies);
+        if (r.skipped) {
+            std::cout << "skip " << c.name << "  no depth <= " << max_depth << "\n";
+            ++skipped;
+            results.push_back(r);
+            continue;
+        }
+        std::cout << (r.ok ? "ok   " : "FAIL ") << c.name << "  depth " << r.depth
+                  << "  nodes " << r.nodes << "  time " << r.seconds << " sec"
+                  << "  nps " << (uint64_t)(r.nodes / std::max(r.seconds, 1e-9)) << "\n";
+        failed += !r.ok;
+        results.push_back(r);
+    }
+
+    write_report(json, suite, opt, results);
+    std::cout << "\n" << (cases.size() - failed - skipped) << "/" << cases.size() << " passed";
+    if (skipped) std::cout << ", " << skipped << " skipped";
+    std::cout << ", report in " << json << "\n";
+    return failed ? 1 : 0;
 }